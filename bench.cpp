@@ -0,0 +1,811 @@
+//============================================================================
+// Name         : bench.cpp
+// Author       : Aysa Binte masud
+// Version      : 01
+// Date Created : 17 October 2026
+// Date Modified: 17 October 2026
+// Description  : Benchmarks of the VFS operations
+//============================================================================
+#include<iostream>
+#include<sstream>
+#include<string>
+#include<chrono>
+#include<cstdio>
+#include<thread>
+#include<fstream>
+#include<algorithm>
+#include<unistd.h>
+#include<sys/resource.h>
+#include<sys/wait.h>
+#include "vfs.hpp"
+using namespace std;
+
+//a stream buffer that drops everything, so that printing does not dominate the timings
+class NullBuffer : public streambuf
+{
+    protected:
+        int overflow(int c) { return c; }
+        streamsize xsputn(const char*, streamsize n) { return n; }
+};
+
+//create a function that fills a VFS (or one folder of it) with folders of ten subfolders and ten files until it holds about n Inodes
+void buildTree(VFS& vfs, size_t n, Inode* top = nullptr) {
+    vector<Inode*> level(1, top != nullptr ? top : vfs.getNode("/"));
+    size_t created = 0;
+    int64_t now = vfs.getTime();
+    while (created < n) {
+        vector<Inode*> next;
+        for (size_t i = 0; i < level.size() && created < n; ++i) {
+            for (int k = 0; k < 10 && created < n; ++k, created += 2) {
+                next.push_back(vfs.createChild(level[i], "dir" + to_string(k), Folder, FOLDER_SIZE, now));
+                vfs.createChild(level[i], "file" + to_string(created) + ".txt", File, 100, now);
+            }
+        }
+        level.swap(next);
+    }
+    //a few Inodes with the name that is searched for
+    for (int k = 0; k < 4 && k < (int)level.size(); ++k) {
+        vfs.createChild(level[level.size() * k / 4], "needle.txt", File, 1, now);
+    }
+}
+
+//create a function that returns the average time of fn in microseconds
+template <typename F>
+double timeIt(F fn, int runs) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int i = 0; i < runs; ++i) {
+        fn();
+    }
+    return chrono::duration<double, micro>(chrono::steady_clock::now() - start).count() / runs;
+}
+
+//find with the name index against a walk of the whole tree, for growing trees
+void benchFind() {
+    printf("find needle.txt (4 matches)\n");
+    printf("%12s %16s %16s\n", "Inodes", "indexed (us)", "tree walk (us)");
+    NullBuffer null_buffer;
+    for (size_t n = 10000; n <= 1000000; n *= 10) {
+        VFS vfs;
+        buildTree(vfs, n);
+        streambuf* saved = cout.rdbuf(&null_buffer);
+        double indexed = timeIt([&]() { vfs.find("needle.txt"); }, 1000);
+        double walk = timeIt([&]() { vfs.find_helper(vfs.getNode("/"), "needle.txt", ""); }, n >= 1000000 ? 3 : 20);
+        cout.rdbuf(saved);
+        printf("%12zu %16.2f %16.2f\n", n, indexed, walk);
+    }
+}
+
+//pattern find with 1, 2, 4 and 8 workers, on Inodes and on a mounted snapshot that has not been materialized
+void benchPattern() {
+    const size_t n = 1000000;
+    printf("find *7.txt over %zu Inodes\n", n);
+    printf("%8s %16s %16s\n", "threads", "Inodes (ms)", "snapshot (ms)");
+    NullBuffer null_buffer;
+    VFS tree, mapped;
+    buildTree(tree, n);
+    streambuf* saved = cout.rdbuf(&null_buffer);
+    tree.save("/tmp/vfs_bench.snap");
+    mapped.mount("/tmp/vfs_bench.snap");
+    for (unsigned threads = 1; threads <= 8; threads *= 2) {
+        tree.setFindThreads(threads);
+        mapped.setFindThreads(threads);
+        double in_tree = timeIt([&]() { tree.findPattern("*7.txt", false); }, 5) / 1000;
+        double in_snapshot = timeIt([&]() { mapped.findPattern("*7.txt", false); }, 5) / 1000;
+        cout.rdbuf(saved);
+        printf("%8u %16.2f %16.2f\n", threads, in_tree, in_snapshot);
+        cout.rdbuf(&null_buffer);
+    }
+    cout.rdbuf(saved);
+    remove("/tmp/vfs_bench.snap");
+}
+
+//getNode on a path 8, 32 and 128 levels deep: the first lookup walks the components, the repeated ones hit the cache
+void benchPaths() {
+    printf("getNode of a deep path\n");
+    printf("%8s %16s %16s\n", "depth", "first (ns)", "repeated (ns)");
+    for (int depth = 8; depth <= 128; depth *= 4) {
+        VFS vfs;
+        Inode* node = vfs.getNode("/");
+        string path;
+        for (int d = 0; d < depth; ++d) {
+            node = vfs.createChild(node, "level" + to_string(d), Folder, FOLDER_SIZE, 0);
+            path += "/level" + to_string(d);
+        }
+        double first = timeIt([&]() { vfs.getNode(path); }, 1) * 1000;
+        double repeated = timeIt([&]() { vfs.getNode(path); }, 1000000) * 1000;
+        printf("%8d %16.1f %16.1f\n", depth, first, repeated);
+    }
+}
+
+//pwd, find, and rm and recover of a file at the bottom of a chain of 1k and 10k folders, where the paths are long
+void benchDeep() {
+    printf("paths at the bottom of a chain of folders\n");
+    printf("%8s %12s %12s %12s %14s\n", "depth", "pwd (us)", "find (us)", "rm (us)", "recover (us)");
+    NullBuffer null_buffer;
+    ostream out(&null_buffer);
+    Session s(out);
+    for (int depth = 1000; depth <= 10000; depth *= 10) {
+        VFS vfs;
+        Inode* node = vfs.getNode("/");
+        for (int d = 0; d < depth; ++d) {
+            node = vfs.createChild(node, "level" + to_string(d), Folder, FOLDER_SIZE, 0);
+        }
+        vfs.createChild(node, "needle.txt", File, 1, 0);
+        string path;
+        vfs.pathOf(node, path);
+        vfs.cd(s, path);
+        double pwd = timeIt([&]() { vfs.pwd(s); }, 1000);
+        double find = timeIt([&]() { vfs.find(s, "needle.txt"); }, 1000);
+        double rm = 0, recover = 0;
+        for (int i = 0; i < 1000; ++i) {
+            rm += timeIt([&]() { vfs.rm(s, "needle.txt"); }, 1);
+            recover += timeIt([&]() { vfs.recover(s, "needle.txt"); }, 1);
+        }
+        printf("%8d %12.2f %12.2f %12.2f %14.2f\n", depth, pwd, find, rm / 1000, recover / 1000);
+    }
+}
+
+//rm of many files, recover of single items by number and by path, and the purge of all of them a share at a time
+void benchBin() {
+    printf("bin with n removed files\n");
+    printf("%10s %12s %14s %14s %12s\n", "items", "rm (ns)", "recover (ns)", "by path (ns)", "step (ms)");
+    NullBuffer null_buffer;
+    for (int n = 1000; n <= 100000; n *= 10) {
+        VFS vfs;
+        Inode* root = vfs.getNode("/");
+        for (int i = 0; i < n; ++i) {
+            vfs.createChild(root, "f" + to_string(i) + ".txt", File, 100, 0);
+        }
+        streambuf* saved = cout.rdbuf(&null_buffer);
+        int i = 0;
+        double rm = timeIt([&]() { vfs.rm("f" + to_string(i++) + ".txt"); }, n) * 1000;
+        //put every tenth item back, from the middle of the bin, then remove it again
+        int k = 0;
+        double recover = timeIt([&]() { vfs.recover(to_string(n / 2 + k)); vfs.rm("f" + to_string(n / 2 + k - 1) + ".txt"); k += 10; }, n / 20) * 1000;
+        k = 0;
+        double by_path = timeIt([&]() { vfs.recover("/f" + to_string(k) + ".txt"); vfs.rm("f" + to_string(k) + ".txt"); k += 10; }, n / 20) * 1000;
+        vfs.binlimit("0", "");
+        double purge = timeIt([&]() { vfs.maintain(); }, 1 + n / 4096) / 1000;
+        cout.rdbuf(saved);
+        printf("%10d %12.1f %14.1f %14.1f %12.2f\n", n, rm, recover, by_path, purge);
+    }
+}
+
+//create a function that returns the live Inodes of a VFS, as the arena command prints them
+size_t liveInodes(VFS& vfs) {
+    ostringstream out;
+    streambuf* saved = cout.rdbuf(out.rdbuf());
+    vfs.arena();
+    cout.rdbuf(saved);
+    string text = out.str();//"Inodes live: n" is the first line
+    size_t colon = text.find(':');
+    return colon != string::npos ? strtoull(text.c_str() + colon + 1, nullptr, 10) : 0;
+}
+
+//create a function that collects the paths of the folders down to a depth, for the sessions to cd into
+void folderPaths(Inode* node, const string& path, int depth, vector<string>& paths) {
+    Vector<Inode*>& children = node->getChildren();
+    for (int i = 0; i < children.size(); ++i) {
+        if (children[i]->getType() == Folder) {
+            string child = path + "/" + children[i]->getName();
+            paths.push_back(child);
+            if (depth > 1) {
+                folderPaths(children[i], child, depth - 1, paths);
+            }
+        }
+    }
+}
+
+//cp -r of a template to 100 tenants, then one touch deep inside each copy: the copies cost an Inode each until they diverge
+void benchClone() {
+    const int tenants = 100;
+    printf("cp -r of a template to %d tenants, then a touch 4 levels down in each\n", tenants);
+    printf("%10s %10s %14s %12s %14s %14s\n", "template", "cp (us)", "Inodes after", "touch (us)", "Inodes after", "Inodes (full)");
+    NullBuffer null_buffer;
+    for (size_t n = 10000; n <= 1000000; n *= 10) {
+        VFS vfs;
+        Inode* root = vfs.getNode("/");
+        buildTree(vfs, n, vfs.createChild(root, "template", Folder, FOLDER_SIZE, 0));
+        size_t before = liveInodes(vfs);
+        streambuf* saved = cout.rdbuf(&null_buffer);
+        int i = 0;
+        double cp = timeIt([&]() { vfs.cp("/template", "/tenant" + to_string(i++), true); }, tenants);
+        size_t shared = liveInodes(vfs);
+        i = 0;
+        double touch = timeIt([&]() {
+            vfs.cd("/tenant" + to_string(i++) + "/dir1/dir2/dir3/dir4");
+            vfs.touch("local.txt", 1);
+        }, tenants);
+        cout.rdbuf(saved);
+        printf("%10zu %10.2f %14zu %12.2f %14zu %14zu\n", before, cp, shared, touch, liveInodes(vfs), before * (tenants + 1));
+    }
+}
+
+//a snapshot of a tree of about 1M Inodes, then touches in 1 to 1000 folders 4 levels down: the Inodes the snapshot gains are its memory overhead
+void benchSnapshot() {
+    printf("snapshot of 1M Inodes, then touches in n folders\n");
+    printf("%8s %14s %12s %16s %14s\n", "touches", "snapshot (us)", "touch (us)", "snapshot Inodes", "snapshot KB");
+    NullBuffer null_buffer;
+    for (int n = 1; n <= 1000; n *= 10) {
+        VFS vfs;
+        buildTree(vfs, 1000000);
+        streambuf* saved = cout.rdbuf(&null_buffer);
+        double take = timeIt([&]() { vfs.snapshotCommand("create", "s"); }, 1);
+        int i = 0;
+        double touch = timeIt([&]() {
+            int k = i++;
+            vfs.cd("/dir" + to_string(k % 10) + "/dir" + to_string(k / 10 % 10) + "/dir" + to_string(k / 100 % 10) + "/dir" + to_string(k / 1000 % 10));
+            vfs.touch("new.txt", 1);
+        }, n);
+        cout.rdbuf(saved);
+        size_t inodes, bytes;
+        vfs.footprint(vfs.findView("s"), inodes, bytes);
+        printf("%8d %14.2f %12.2f %16zu %14zu\n", n, take, touch, inodes, bytes / 1024);
+    }
+}
+
+//one folder of n files in random order: the whole listing, and pages and prefixes of it in name and size order
+void benchLs() {
+    printf("ls of one folder of n files\n");
+    printf("%9s %12s %12s %12s %12s %12s %12s\n", "files", "add (ns)", "ls (ms)", "page (us)", "after (us)", "prefix (us)", "size (ms)");
+    NullBuffer null_buffer;
+    ostream out(&null_buffer);
+    Session s(out);
+    for (size_t n = 10000; n <= 1000000; n *= 10) {
+        VFS vfs;
+        Inode* folder = vfs.createChild(vfs.getNode("/"), "big", Folder, FOLDER_SIZE, 0);
+        vector<size_t> order(n);
+        for (size_t i = 0; i < n; ++i) {
+            order[i] = i;
+        }
+        uint64_t seed = 1;
+        for (size_t i = n - 1; i > 0; --i) {
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            swap(order[i], order[(seed >> 33) % (i + 1)]);
+        }
+        size_t i = 0;
+        double add = timeIt([&]() { vfs.createChild(folder, "exp" + to_string(order[i]) + ".txt", File, order[i] % 1000, 0); i++; }, n) * 1000;
+        vfs.cd(s, "/big");
+        double all = timeIt([&]() { vfs.ls(s); }, 3) / 1000;
+        double page = timeIt([&]() { vfs.ls(s, "--limit 100"); }, 100);
+        double after = timeIt([&]() { vfs.ls(s, "--limit 100 --after exp" + to_string(n / 2) + ".txt"); }, 100);
+        double prefix = timeIt([&]() { vfs.ls(s, "exp1234*"); }, 100);
+        double size = timeIt([&]() { vfs.ls(s, "--sort size --limit 100"); }, 3) / 1000;
+        printf("%9zu %12.1f %12.2f %12.2f %12.2f %12.2f %12.2f\n", n, add, all, page, after, prefix, size);
+    }
+}
+
+//sessions on 1 to 8 threads against one tree: a read-only mix (cd, ls, pwd, size, find) and the same with 1 command in 10 a mkdir or touch
+void benchSessions() {
+    const int OPS = 20000;//commands per session
+    printf("concurrent sessions, %d commands each\n", OPS);
+    printf("%8s %18s %18s\n", "threads", "reads (kops/s)", "mixed (kops/s)");
+    VFS vfs;
+    buildTree(vfs, 100000);
+    vector<string> paths;
+    folderPaths(vfs.getNode("/"), "", 4, paths);
+    for (int t = 0; t < 8; ++t) {
+        vfs.createChild(vfs.getNode("/"), "session" + to_string(t), Folder, FOLDER_SIZE, 0);
+    }
+
+    int round = 0;
+    for (unsigned threads = 1; threads <= 8; threads *= 2) {
+        double rate[2];
+        for (int mixed = 0; mixed < 2; ++mixed, ++round) {
+            chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            vector<thread> sessions;
+            for (unsigned t = 0; t < threads; ++t) {
+                sessions.push_back(thread([&, t]() {
+                    NullBuffer null_buffer;
+                    ostream out(&null_buffer);
+                    Session s(out);
+                    uint64_t seed = t * 7919 + 1;
+                    for (int i = 0; i < OPS; ++i) {
+                        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+                        const string& path = paths[(seed >> 33) % paths.size()];
+                        switch (i % 10) {
+                            case 0: case 1: case 2: vfs.cd(s, path); break;
+                            case 3: case 4: vfs.ls(s); break;
+                            case 5: vfs.pwd(s); break;
+                            case 6: vfs.size(s, path); break;
+                            case 7: vfs.cd(s, ".."); break;
+                            case 8: vfs.find(s, "needle.txt"); break;
+                            case 9:
+                                if (mixed) {
+                                    vfs.cd(s, "/session" + to_string(t));
+                                    string name = "r" + to_string(round) + "n" + to_string(i);
+                                    (i / 10) % 2 ? vfs.mkdir(s, name) : vfs.touch(s, name + ".txt", 1);
+                                } else {
+                                    vfs.cd(s, "-");
+                                }
+                                break;
+                        }
+                    }
+                }));
+            }
+            for (size_t k = 0; k < sessions.size(); ++k) {
+                sessions[k].join();
+            }
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            rate[mixed] = threads * OPS / seconds / 1000;
+        }
+        printf("%8u %18.1f %18.1f\n", threads, rate[0], rate[1]);
+    }
+}
+
+//create a function that returns the peak resident set size of the process in KB
+long peakRss() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+//create a function that prints one CSV line for the samples of an operation: the count, ns/op, the percentiles and the peak RSS so far
+void report(const string& tree, const char* op, vector<double>& ns) {
+    if (ns.empty()) {
+        return;
+    }
+    sort(ns.begin(), ns.end());
+    double total = 0;
+    for (size_t i = 0; i < ns.size(); ++i) {
+        total += ns[i];
+    }
+    size_t n = ns.size();
+    printf("%s,%s,%zu,%.0f,%.0f,%.0f,%.0f,%.0f,%ld\n", tree.c_str(), op, n, total / n,
+        ns[n / 2], ns[min(n - 1, n * 9 / 10)], ns[min(n - 1, n * 99 / 100)], ns[n - 1], peakRss());
+}
+
+//create a function that times one call of fn in nanoseconds and adds it to the samples
+template <typename F>
+void sample(vector<double>& ns, F fn) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    fn();
+    ns.push_back(chrono::duration<double, nano>(chrono::steady_clock::now() - start).count());
+}
+
+//create a function that builds one of the trees of the suite and collects its folders and files
+void buildShape(VFS& vfs, const string& shape, vector<Inode*>& folders, vector<Inode*>& files) {
+    Inode* root = vfs.getNode("/");
+    int64_t now = vfs.getTime();
+    if (shape == "wide") {//1M files in one folder
+        Inode* wide = vfs.createChild(root, "wide", Folder, FOLDER_SIZE, now);
+        folders.push_back(wide);
+        for (int i = 0; i < 1000000; ++i) {
+            files.push_back(vfs.createChild(wide, "f" + to_string(i) + ".txt", File, 100, now));
+        }
+    } else if (shape == "deep") {//a chain of 100k folders with a file in every hundredth
+        //createChild adds a size to every ancestor, so the chain is built empty and its sizes are set from the bottom
+        Inode* node = root;
+        for (int i = 0; i < 100000; ++i) {
+            node = vfs.createChild(node, "d", Folder, 0, now);
+            folders.push_back(node);
+        }
+        for (size_t i = folders.size(); i-- > 0; ) {
+            folders[i]->setSize(FOLDER_SIZE * (folders.size() - i));
+        }
+        root->addSize(FOLDER_SIZE * folders.size());
+        for (size_t i = 99; i < folders.size(); i += 100) {
+            files.push_back(vfs.createChild(folders[i], "f" + to_string(i) + ".txt", File, 100, now));
+        }
+    } else {//folders of ten subfolders and ten files, 1M Inodes
+        buildTree(vfs, 1000000);
+        vector<Inode*> stack(1, root);
+        while (!stack.empty()) {
+            Inode* node = stack.back();
+            stack.pop_back();
+            Vector<Inode*>& children = node->getChildren();
+            for (int i = 0; i < children.size(); ++i) {
+                (children[i]->getType() == Folder ? folders : files).push_back(children[i]);
+                if (children[i]->getType() == Folder) {
+                    stack.push_back(children[i]);
+                }
+            }
+        }
+    }
+}
+
+//every operation on one tree shape, a sample per call on random folders and files, and the teardown of the tree
+void benchShape(const string& shape) {
+    const size_t SAMPLES = shape == "deep" ? 20 : 10000;//resolving a path of 100k components takes about a second
+    NullBuffer null_buffer;
+    streambuf* saved = cout.rdbuf(&null_buffer);
+    vector<double> ns;
+
+    VFS* vfs = new VFS();
+    vector<Inode*> folders, files;
+    sample(ns, [&]() { buildShape(*vfs, shape, folders, files); });
+    report(shape, "build", ns);
+
+    //the paths of random folders and files, with their names
+    uint64_t seed = 12345;
+    vector<string> folder_paths(SAMPLES), file_paths(SAMPLES), file_names(SAMPLES);
+    for (size_t i = 0; i < SAMPLES; ++i) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        vfs->pathOf(folders[(seed >> 33) % folders.size()], folder_paths[i]);
+        Inode* file = files[(seed >> 17) % files.size()];
+        vfs->pathOf(file, file_paths[i]);
+        file_names[i] = file->getName();
+    }
+
+    ns.clear();
+    for (size_t i = 0; i < SAMPLES; ++i) sample(ns, [&]() { vfs->getNode(file_paths[i]); });
+    report(shape, "getNode", ns);
+    ns.clear();
+    for (size_t i = 0; i < SAMPLES; ++i) sample(ns, [&]() { vfs->cd(folder_paths[i]); });
+    report(shape, "cd", ns);
+    ns.clear();
+    for (size_t i = 0; i < SAMPLES; ++i) { vfs->cd(folder_paths[i]); sample(ns, [&]() { vfs->pwd(); }); }
+    report(shape, "pwd", ns);
+    ns.clear();
+    for (size_t i = 0; i < SAMPLES; ++i) sample(ns, [&]() { vfs->size(folder_paths[i].substr(1)); });
+    report(shape, "size", ns);
+    ns.clear();
+    for (size_t i = 0; i < SAMPLES; ++i) sample(ns, [&]() { vfs->find(file_names[i]); });
+    report(shape, "find", ns);
+
+    //each sample folder gets a new folder and a file, the file is moved into the folder, which is removed and recovered
+    vector<double> mkdir_ns, touch_ns, mv_ns, rm_ns, recover_ns;
+    for (size_t i = 0; i < SAMPLES; ++i) {
+        string folder = "bench_d" + to_string(i);
+        string file = "bench_f" + to_string(i);
+        vfs->cd(folder_paths[i]);
+        sample(mkdir_ns, [&]() { vfs->mkdir(folder); });
+        sample(touch_ns, [&]() { vfs->touch(file, 10); });
+        sample(mv_ns, [&]() { vfs->mv(file, folder); });
+        sample(rm_ns, [&]() { vfs->rm(folder); });
+    }
+    for (size_t i = 0; i < SAMPLES; ++i) {
+        string path = (folder_paths[i] == "/" ? "" : folder_paths[i]) + "/bench_d" + to_string(i);
+        sample(recover_ns, [&]() { vfs->recover(path); });
+    }
+    report(shape, "mkdir", mkdir_ns);
+    report(shape, "touch", touch_ns);
+    report(shape, "mv", mv_ns);
+    report(shape, "rm", rm_ns);
+    report(shape, "recover", recover_ns);
+
+    ns.clear();
+    for (int i = 0; i < 3; ++i) {
+        ofstream fout("/tmp/vfs_bench.dat");
+        sample(ns, [&]() { vfs->write(fout, vfs->getNode("/")); });
+    }
+    remove("/tmp/vfs_bench.dat");
+    report(shape, "write", ns);
+
+    ns.clear();
+    sample(ns, [&]() { delete vfs; });
+    report(shape, "teardown", ns);
+    cout.rdbuf(saved);
+}
+
+//the suite on the wide, deep and balanced trees as CSV; each tree is built in a child process so the peak RSS is its own
+void benchOps(const string& only) {
+    printf("tree,op,samples,mean_ns,p50_ns,p90_ns,p99_ns,max_ns,peak_rss_kb\n");
+    const char* shapes[] = {"wide", "deep", "balanced"};
+    for (int k = 0; k < 3; ++k) {
+        if (!only.empty() && only != shapes[k]) {
+            continue;
+        }
+        fflush(stdout);
+        pid_t child = fork();
+        if (child == 0) {
+            benchShape(shapes[k]);
+            fflush(stdout);
+            _exit(0);
+        }
+        int status;
+        waitpid(child, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            fprintf(stderr, "the %s tree failed\n", shapes[k]);
+        }
+    }
+}
+
+//create a function that runs the same work on Vector and std::vector and prints both times
+template <typename F, typename G>
+void compare(const char* name, F mine, G standard, int runs) {
+    double a = timeIt(mine, runs);
+    double b = timeIt(standard, runs);
+    printf("%-36s %12.1f %12.1f\n", name, a, b);
+}
+
+volatile uint64_t sink;//keeps the optimizer from dropping the loops
+
+//Vector against std::vector on the operations the tree uses
+void benchVector() {
+    printf("%-36s %12s %12s\n", "Vector vs std::vector (us)", "Vector", "std::vector");
+    const int n = 1000000;
+    compare("push_back 1M pointers", [&]() {
+        Vector<Inode*> v;
+        for (int i = 0; i < n; ++i) v.push_back(reinterpret_cast<Inode*>(i));
+        sink = v.size();
+    }, [&]() {
+        vector<Inode*> v;
+        for (int i = 0; i < n; ++i) v.push_back(reinterpret_cast<Inode*>(i));
+        sink = v.size();
+    }, 10);
+
+    Vector<Inode*> mine;
+    vector<Inode*> standard;
+    for (int i = 0; i < n; ++i) {
+        mine.push_back(reinterpret_cast<Inode*>(i));
+        standard.push_back(reinterpret_cast<Inode*>(i));
+    }
+    compare("iterate 1M pointers", [&]() {
+        uint64_t sum = 0;
+        for (Inode **it = mine.begin(), **last = mine.end(); it != last; ++it) sum += reinterpret_cast<uintptr_t>(*it);
+        sink = sum;
+    }, [&]() {
+        uint64_t sum = 0;
+        for (vector<Inode*>::iterator it = standard.begin(), last = standard.end(); it != last; ++it) sum += reinterpret_cast<uintptr_t>(*it);
+        sink = sum;
+    }, 100);
+
+    compare("100k folders of 5 children", [&]() {
+        for (int f = 0; f < 100000; ++f) {
+            Vector<Inode*> v;
+            for (int i = 0; i < 5; ++i) v.push_back(nullptr);
+            sink = v.size();
+        }
+    }, [&]() {
+        for (int f = 0; f < 100000; ++f) {
+            vector<Inode*> v;
+            for (int i = 0; i < 5; ++i) v.push_back(nullptr);
+            sink = v.size();
+        }
+    }, 10);
+
+    compare("erase front of 10k until empty", [&]() {
+        Vector<Inode*> v;
+        for (int i = 0; i < 10000; ++i) v.push_back(nullptr);
+        while (!v.empty()) v.erase(0);
+        sink = v.size();
+    }, [&]() {
+        vector<Inode*> v;
+        for (int i = 0; i < 10000; ++i) v.push_back(nullptr);
+        while (!v.empty()) v.erase(v.begin());
+        sink = v.size();
+    }, 10);
+
+    compare("swap_erase 10k until empty", [&]() {
+        Vector<Inode*> v;
+        for (int i = 0; i < 10000; ++i) v.push_back(nullptr);
+        while (!v.empty()) v.swap_erase(0);
+        sink = v.size();
+    }, [&]() {
+        vector<Inode*> v;
+        for (int i = 0; i < 10000; ++i) v.push_back(nullptr);
+        while (!v.empty()) { v[0] = v.back(); v.pop_back(); }
+        sink = v.size();
+    }, 10);
+
+    compare("push_back 100k strings", [&]() {
+        Vector<string> v;
+        for (int i = 0; i < 100000; ++i) v.push_back(string(24, 'x'));
+        sink = v.size();
+    }, [&]() {
+        vector<string> v;
+        for (int i = 0; i < 100000; ++i) v.push_back(string(24, 'x'));
+        sink = v.size();
+    }, 10);
+}
+
+//sequential write and read of a 1 GB file in pieces of 4 KB to 1 MB: the first write (the blocks get their pages), a rewrite into freed blocks, and reads through the spans
+void benchFiles() {
+    const size_t TOTAL = 1 << 30;
+    const char* caches[] = {"2048", "256"};//one that holds the file, one it spills out of
+    printf("sequential write and read of a %zu MB file\n", TOTAL >> 20);
+    printf("%10s %10s %14s %14s %14s %14s %10s %12s\n", "cache MB", "piece", "write GB/s", "rewrite GB/s", "read GB/s", "copy GB/s", "hit rate", "pwritev");
+    NullBuffer null_buffer;
+    ostream out(&null_buffer);
+    vector<char> buffer(1 << 20);
+    for (size_t c = 0; c < sizeof(caches) / sizeof(caches[0]); ++c) {
+        for (size_t piece = 4096; piece <= (1 << 20); piece *= 16) {
+            VFS vfs;
+            Session s(out);//its working folder is an Inode of this vfs
+            streambuf* saved = cout.rdbuf(&null_buffer);
+            vfs.cache(caches[c]);
+            cout.rdbuf(saved);
+            string text(piece, 'x');
+            uint64_t stamp = 0;
+            auto next = [&]() {//a number in every block, so that no two blocks are the same
+                for (size_t i = 0; i < piece; i += BLOCK_BYTES, stamp++) {
+                    memcpy(&text[i], &stamp, sizeof(stamp));
+                }
+                vfs.writeFile(s, "big.dat", text, true);
+            };
+            double write = timeIt(next, TOTAL / piece) * (TOTAL / piece) / 1e6;
+            vfs.truncate(s, "big.dat", "0");
+            double rewrite = timeIt(next, TOTAL / piece) * (TOTAL / piece) / 1e6;
+
+            //read every byte in place, then copy it out the way a read() into a buffer would
+            Inode* file = vfs.getNode("/big.dat");
+            CacheStats before = vfs.cacheStats();
+            uint64_t sum = 0;
+            double read = timeIt([&]() {
+                for (size_t offset = 0; offset < TOTAL; offset += piece) {
+                    vfs.readContents(file, offset, piece, [&sum](const char* from, uint64_t n) {
+                        const uint64_t* words = reinterpret_cast<const uint64_t*>(from);
+                        for (size_t k = 0; k < n / 8; ++k) {
+                            sum += words[k];
+                        }
+                    });
+                }
+            }, 1) / 1e6;
+            double copy = timeIt([&]() {
+                for (size_t offset = 0; offset < TOTAL; offset += piece) {
+                    char* to = buffer.data();
+                    vfs.readContents(file, offset, piece, [&to](const char* from, uint64_t n) { memcpy(to, from, n); to += n; });
+                    sum += buffer[piece - 1];
+                }
+            }, 1) / 1e6;
+            CacheStats after = vfs.cacheStats();
+            uint64_t hits = after.hits - before.hits, lookups = hits + after.misses - before.misses;
+            double gb = TOTAL / 1e9;
+            printf("%10s %10zu %14.2f %14.2f %14.2f %14.2f %9.1f%% %12llu\n", caches[c], piece, gb / write, gb / rewrite, gb / read, gb / copy,
+                   lookups > 0 ? 100.0 * hits / lookups : 0.0, (unsigned long long)after.write_calls);
+            sink = sum;
+        }
+    }
+}
+
+//files written by content, from all of them different to all of them copies of a few templates: ingest speed and what the blocks take
+void benchDedup() {
+    const size_t FILES = 2048, BYTES = 64 << 10, TEMPLATES = 16;
+    printf("writing %zu files of %zu KB, a share of them the same as one of %zu templates\n", FILES, BYTES >> 10, TEMPLATES);
+    printf("%10s %12s %12s %12s %10s %12s\n", "same", "ingest GB/s", "logical MB", "physical MB", "ratio", "found");
+    NullBuffer null_buffer;
+    ostream out(&null_buffer);
+    uint64_t seed = 7;
+    vector<string> templates(TEMPLATES, string(BYTES, ' '));
+    for (size_t t = 0; t < TEMPLATES; ++t) {
+        for (size_t i = 0; i < BYTES; i += 8) {
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            memcpy(&templates[t][i], &seed, 8);
+        }
+    }
+    const int shares[] = {0, 50, 90, 100};
+    for (size_t k = 0; k < sizeof(shares) / sizeof(shares[0]); ++k) {
+        //the contents are made before the timing; a file of its own is a template with a number in every block
+        vector<string> texts(FILES);
+        for (size_t f = 0; f < FILES; ++f) {
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            texts[f] = templates[(seed >> 40) % TEMPLATES];
+            if ((int)((seed >> 20) % 100) >= shares[k]) {
+                for (size_t i = 0; i < BYTES; i += BLOCK_BYTES) {
+                    memcpy(&texts[f][i], &f, sizeof(f));
+                }
+            }
+        }
+        VFS vfs;
+        Session s(out);
+        streambuf* saved = cout.rdbuf(&null_buffer);
+        vfs.cache("1024");//the files fit, so the timing is the store and not the disk
+        cout.rdbuf(saved);
+        size_t f = 0;
+        double us = timeIt([&]() { vfs.writeFile(s, "file" + to_string(f), texts[f], false); f++; }, FILES) * FILES;
+        DedupStats d = vfs.dedupStats();
+        printf("%9d%% %12.2f %12.1f %12.1f %10.2f %12llu\n", shares[k], FILES * BYTES / 1e3 / us, d.referenced * BLOCK_BYTES / 1048576.0,
+               d.physical * BLOCK_BYTES / 1048576.0, d.physical > 0 ? (double)d.referenced / d.physical : 1.0, (unsigned long long)d.hits);
+    }
+}
+
+//create a function that runs commands in a session until done is set, timing each of them in microseconds
+void runCommands(VFS& vfs, Session& s, atomic<bool>& done, vector<double>& us, size_t& count) {
+    static const char* paths[] = {"/dir3/dir4/dir5", "/dir7/dir1", "/dir0/dir9/dir2/dir6"};
+    while (!done) {
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        switch (count % 4) {
+            case 0: vfs.mkdir(s, "m" + to_string(count)); break;
+            case 1: vfs.touch(s, "t" + to_string(count) + ".txt", 1); break;
+            case 2: vfs.cd(s, paths[count / 4 % 3]); vfs.ls(s); break;
+            case 3: vfs.cd(s, "/bench"); break;
+        }
+        vfs.maintain();//as the shell does after every command
+        us.push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - start).count());
+        count++;
+    }
+}
+
+//a checkpoint of a large tree written while a session keeps running commands: none, a save that holds the lock, and one written in the background
+void benchCheckpoint() {
+    const size_t N = 1000000;
+    char dir[] = "/tmp/vfsbenchXXXXXX";
+    if (mkdtemp(dir) == nullptr) {
+        return;
+    }
+    string journal_file = string(dir) + "/vfs.journal", snapshot_file = string(dir) + "/vfs.snap";
+    NullBuffer null_buffer;
+    ostream out(&null_buffer);
+    VFS vfs;
+    buildTree(vfs, N);
+    vfs.openJournal(journal_file, snapshot_file);
+    Session s(out);
+    vfs.mkdir(s, "bench");
+    vfs.cd(s, "/bench");
+    printf("checkpoint of a %zu Inode tree while a session runs mkdir, touch, cd and ls\n", N);
+
+    const char* modes[] = {"none", "sync", "background"};
+    vector<string> lines;
+    for (int mode = 0; mode < 3; ++mode) {
+        atomic<bool> done(false);
+        double seconds = 0;
+        thread other([&]() {//the session that asks for the checkpoint
+            chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            if (mode == 0) {
+                this_thread::sleep_for(chrono::milliseconds(500));
+            } else if (mode == 1) {
+                vfs.checkpoint();
+            } else {
+                vfs.startCheckpoint();
+                vfs.waitCheckpoint();
+            }
+            seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            done = true;
+        });
+        vector<double> us;
+        size_t count = 0;
+        runCommands(vfs, s, done, us, count);
+        other.join();
+        sort(us.begin(), us.end());
+        char line[160];
+        snprintf(line, sizeof(line), "%12s %10.3f %10zu %10.1f %10.1f %12.1f", modes[mode], seconds, us.size(),
+                 us.empty() ? 0.0 : us[us.size() / 2], us.empty() ? 0.0 : us[min(us.size() - 1, us.size() * 99 / 100)], us.empty() ? 0.0 : us.back());
+        lines.push_back(line);
+    }
+    printf("%12s %10s %10s %10s %10s %12s\n", "checkpoint", "seconds", "commands", "p50 us", "p99 us", "max us");
+    for (size_t i = 0; i < lines.size(); ++i) {
+        printf("%s\n", lines[i].c_str());
+    }
+    remove(journal_file.c_str());
+    remove(snapshot_file.c_str());
+    rmdir(dir);
+}
+
+int main(int argc, char* argv[])
+{
+    string which = argc > 1 ? argv[1] : "all";
+    if (which == "all" || which == "find") {
+        benchFind();
+    }
+    if (which == "all" || which == "vector") {
+        benchVector();
+    }
+    if (which == "all" || which == "paths") {
+        benchPaths();
+    }
+    if (which == "all" || which == "deep") {
+        benchDeep();
+    }
+    if (which == "all" || which == "pattern") {
+        benchPattern();
+    }
+    if (which == "all" || which == "bin") {
+        benchBin();
+    }
+    if (which == "all" || which == "sessions") {
+        benchSessions();
+    }
+    if (which == "all" || which == "clone") {
+        benchClone();
+    }
+    if (which == "all" || which == "snapshot") {
+        benchSnapshot();
+    }
+    if (which == "all" || which == "ls") {
+        benchLs();
+    }
+    if (which == "all" || which == "files") {
+        benchFiles();
+    }
+    if (which == "all" || which == "dedup") {
+        benchDedup();
+    }
+    if (which == "all" || which == "checkpoint") {
+        benchCheckpoint();
+    }
+    if (which == "all" || which == "ops") {
+        benchOps(argc > 2 ? argv[2] : "");
+    }
+    return 0;
+}
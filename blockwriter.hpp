@@ -0,0 +1,177 @@
+//============================================================================
+// Name         : blockwriter.hpp
+// Author       : Aysa Binte masud
+// Version      : 01
+// Date Created : 17 October 2026
+// Date Modified: 17 October 2026
+// Description  : Buffered writer of a file that is renamed into place in C++
+//============================================================================
+//
+// A snapshot file is written through one buffer of 8 MB aligned to a page,
+// which goes to the kernel in whole buffers, so a save of any size makes a
+// write call per 8 MB instead of one per column or per file. The bytes go
+// to filename.tmp; commit writes the rest, fdatasyncs the file, renames it
+// over filename and syncs the folder, so after a crash the name holds the
+// old file or the whole new one. A writer that is not committed removes its
+// temporary file. The buffer and the write sizes are multiples of a page,
+// the way O_DIRECT wants them, but the file goes through the page cache so
+// the file systems that refuse O_DIRECT (tmpfs) can hold snapshots too.
+//
+#ifndef BLOCKWRITER_H
+#define BLOCKWRITER_H
+#include<cerrno>
+#include<cstdint>
+#include<cstdlib>
+#include<cstring>
+#include<cstdio>
+#include<string>
+#include<algorithm>
+#include<fcntl.h>
+#include<unistd.h>
+using namespace std;
+
+class BlockWriter
+{
+    private:
+        static const size_t BUFFER_BYTES = 8 << 20;
+        static const size_t ALIGNMENT = 4096;
+        char *buffer;
+        size_t used;                    //bytes gathered in the buffer
+        int fd;                         //the temporary file, -1 if none is open
+        string target, temp;
+        bool failed;                    //a write failed, commit will not rename
+        uint64_t written;               //bytes handed to the kernel
+        uint64_t calls;                 //write calls that took them
+
+        bool flush();
+
+        BlockWriter(const BlockWriter&);
+        BlockWriter& operator=(const BlockWriter&);
+    public:
+        BlockWriter();
+        ~BlockWriter();
+        bool open(const string& filename);      //start writing filename.tmp
+        void write(const void* data, size_t length);
+        void zeros(size_t length);              //padding
+        bool commit();                          //sync the file and rename it over filename
+        void abort();                           //remove the temporary file
+        uint64_t bytes() const;                 //bytes written so far
+        uint64_t writeCalls() const;
+};
+//================================================
+
+const size_t BlockWriter::BUFFER_BYTES;
+const size_t BlockWriter::ALIGNMENT;
+
+BlockWriter::BlockWriter() : buffer(nullptr), used(0), fd(-1), failed(false), written(0), calls(0) {
+}
+
+BlockWriter::~BlockWriter() {
+    abort();
+    free(buffer);
+}
+
+bool BlockWriter::open(const string& filename) {
+    abort();
+    if (buffer == nullptr && posix_memalign(reinterpret_cast<void**>(&buffer), ALIGNMENT, BUFFER_BYTES) != 0) {
+        buffer = nullptr;
+        return false;
+    }
+    target = filename;
+    temp = filename + ".tmp";
+    fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    used = 0;
+    failed = fd < 0;
+    written = 0;
+    calls = 0;
+    return fd >= 0;
+}
+
+//create a method that hands the buffer to the kernel, retrying short writes
+bool BlockWriter::flush() {
+    size_t done = 0;
+    while (done < used && !failed) {
+        ssize_t n = ::write(fd, buffer + done, used - done);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            failed = true;
+            break;
+        }
+        done += n;
+        calls++;
+    }
+    written += done;
+    used = 0;
+    return !failed;
+}
+
+//create a method that copies into the buffer and writes it out each time it fills
+void BlockWriter::write(const void* data, size_t length) {
+    const char* from = static_cast<const char*>(data);
+    while (length > 0 && fd >= 0) {
+        size_t piece = min(length, BUFFER_BYTES - used);
+        memcpy(buffer + used, from, piece);
+        used += piece;
+        from += piece;
+        length -= piece;
+        if (used == BUFFER_BYTES) {
+            flush();
+        }
+    }
+}
+
+void BlockWriter::zeros(size_t length) {
+    while (length > 0 && fd >= 0) {
+        size_t piece = min(length, BUFFER_BYTES - used);
+        memset(buffer + used, 0, piece);
+        used += piece;
+        length -= piece;
+        if (used == BUFFER_BYTES) {
+            flush();
+        }
+    }
+}
+
+//create a method that makes the file durable before its name is, then the name
+bool BlockWriter::commit() {
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = flush() && fdatasync(fd) == 0;
+    ok = ::close(fd) == 0 && ok;
+    fd = -1;
+    if (!ok || rename(temp.c_str(), target.c_str()) != 0) {
+        remove(temp.c_str());
+        return false;
+    }
+    //the rename is in the folder, which is synced for it to last
+    size_t slash = target.find_last_of('/');
+    string folder = slash == string::npos ? "." : (slash == 0 ? "/" : target.substr(0, slash));
+    int dir = ::open(folder.c_str(), O_RDONLY);
+    if (dir >= 0) {
+        fsync(dir);
+        ::close(dir);
+    }
+    return true;
+}
+
+void BlockWriter::abort() {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+        remove(temp.c_str());
+    }
+    used = 0;
+}
+
+uint64_t BlockWriter::bytes() const {
+    return written + used;
+}
+
+uint64_t BlockWriter::writeCalls() const {
+    return calls;
+}
+
+#endif
@@ -0,0 +1,161 @@
+//============================================================================
+// Name         : clone.hpp
+// Author       : Aysa Binte masud
+// Version      : 01
+// Date Created : 17 October 2026
+// Date Modified: 17 October 2026
+// Description  : Copy-on-write copies of folders in C++
+//============================================================================
+//
+// A copy of a folder is a single lazy Inode linked to the folder it copies,
+// its origin. Its children are created only when they are first needed,
+// as copies of the origin's children that are lazy in turn, so copying a
+// subtree of any size is O(1) and memory grows with what is used. Before a
+// folder changes, every copy linked to it (or to one of its ancestors) is
+// expanded, one level per folder on the path, so the copies keep what the
+// folder held when they were made; VFS::unshare does that. An origin is
+// always a materialized folder: a copy of a copy links to the same origin,
+// and a copy of a folder that is still in a mapped snapshot becomes another
+// lazy Inode of the snapshot. A point-in-time view of the namespace is a
+// copy of the root kept outside the tree: taking one is O(1), and every
+// later change expands the view only along the path to the change. A
+// copy of a file holds the same contents until either of them is written.
+//
+#ifndef CLONE_H
+#define CLONE_H
+#include<cstdint>
+#include<string>
+#include<vector>
+#include<unordered_map>
+#include "inode.hpp"
+#include "slabpool.hpp"
+#include "nameindex.hpp"
+#include "filestore.hpp"
+using namespace std;
+
+//a point-in-time view of the whole tree: a copy of the root that is kept outside it and never changes
+struct SnapshotView
+{
+    string name;                    //the view is reached as /.snap/name
+    Inode* root;                    //the copy of the root
+    int64_t created;                //time the view was taken
+};
+
+class CloneSource : public ChildSource
+{
+    private:
+        SlabPool<Inode> *pool;          //where the copies are allocated
+        NameIndex *name_index;          //where the copies are indexed
+        unordered_map<Inode*, Inode*> origin_of;        //origin of every copy that was not expanded
+        unordered_multimap<Inode*, Inode*> copies_of;   //the copies linked to each origin
+        uint64_t expanded;              //number of copies expanded so far
+
+        void link(Inode* copy, Inode* origin);
+        void unlink(Inode* copy);
+
+        CloneSource(const CloneSource&);
+        CloneSource& operator=(const CloneSource&);
+    public:
+        CloneSource(SlabPool<Inode>* pool, NameIndex* name_index);
+        Inode* copy(Inode* original, Inode* parent, const string& name);    //a copy of original under parent, not added to parent's children
+        void expand(Inode* node);                       //create the children of a copy from its origin
+        void share(Inode* copy, Inode* original);       //link copy to the origin of the copy original
+        Inode* origin(Inode* node);                     //the folder a copy was not expanded from yet
+        void copiesOf(Inode* folder, vector<Inode*>& copies) const;    //the copies linked to folder
+        void forget(Inode* node);                       //a copy that was not expanded is being destroyed
+        void clear();                                   //drop every link, when the Inodes are destroyed
+        size_t size() const;                            //number of copies not expanded yet
+        uint64_t expandedCount() const;
+};
+//================================================
+
+CloneSource::CloneSource(SlabPool<Inode>* pool, NameIndex* name_index) : pool(pool), name_index(name_index), expanded(0) {
+}
+
+void CloneSource::link(Inode* copy, Inode* origin) {
+    copy->lazy = this;
+    origin_of[copy] = origin;
+    copies_of.insert(make_pair(origin, copy));
+}
+
+void CloneSource::unlink(Inode* copy) {
+    unordered_map<Inode*, Inode*>::iterator it = origin_of.find(copy);
+    if (it == origin_of.end()) {
+        return;
+    }
+    pair<unordered_multimap<Inode*, Inode*>::iterator, unordered_multimap<Inode*, Inode*>::iterator> range = copies_of.equal_range(it->second);
+    for (unordered_multimap<Inode*, Inode*>::iterator c = range.first; c != range.second; ++c) {
+        if (c->second == copy) {
+            copies_of.erase(c);
+            break;
+        }
+    }
+    origin_of.erase(it);
+}
+
+//create a method that makes one Inode standing for original and everything below it
+Inode* CloneSource::copy(Inode* original, Inode* parent, const string& name) {
+    Inode* node = pool->create(name, parent, original->getType(), original->getSize(), original->getCreationEpoch());
+    name_index->insert(node);
+    if (original->data != nullptr) {//a file's contents are shared until one of the two writes
+        node->data = FileStore::share(original->data);
+    }
+    if (original->getType() == Folder) {
+        if (original->lazy != nullptr) {
+            original->lazy->share(node, original);//the children of original are not Inodes yet either
+        } else if (original->children.size() > 0) {
+            link(node, original);
+        }
+    }
+    return node;
+}
+
+//create a method that copies the children of the origin, each of them a copy that stays lazy
+void CloneSource::expand(Inode* node) {
+    unordered_map<Inode*, Inode*>::iterator it = origin_of.find(node);
+    if (it == origin_of.end()) {
+        return;
+    }
+    Inode* origin = it->second;
+    unlink(node);
+    Vector<Inode*>& children = origin->children;
+    for (int i = 0; i < children.size(); ++i) {
+        node->addChild(copy(children[i], node, children[i]->getName()));
+    }
+    expanded++;
+}
+
+void CloneSource::share(Inode* copy, Inode* original) {
+    link(copy, origin_of[original]);
+}
+
+Inode* CloneSource::origin(Inode* node) {
+    unordered_map<Inode*, Inode*>::const_iterator it = origin_of.find(node);
+    return it != origin_of.end() ? it->second : nullptr;
+}
+
+void CloneSource::copiesOf(Inode* folder, vector<Inode*>& copies) const {
+    pair<unordered_multimap<Inode*, Inode*>::const_iterator, unordered_multimap<Inode*, Inode*>::const_iterator> range = copies_of.equal_range(folder);
+    for (unordered_multimap<Inode*, Inode*>::const_iterator c = range.first; c != range.second; ++c) {
+        copies.push_back(c->second);
+    }
+}
+
+void CloneSource::forget(Inode* node) {
+    unlink(node);
+}
+
+void CloneSource::clear() {
+    origin_of.clear();
+    copies_of.clear();
+}
+
+size_t CloneSource::size() const {
+    return origin_of.size();
+}
+
+uint64_t CloneSource::expandedCount() const {
+    return expanded;
+}
+
+#endif
@@ -0,0 +1,193 @@
+//============================================================================
+// Name         : dentrycache.hpp
+// Author       : Aysa Binte masud
+// Version      : 01
+// Date Created : 17 October 2026
+// Date Modified: 17 October 2026
+// Description  : LRU cache of resolved paths in C++
+//============================================================================
+//
+// The cache maps an absolute path to the Inode it resolved to. Each entry
+// records the value of the VFS generation clock when it was last known to
+// be valid. rm, mv and recover advance the clock and set the generation of
+// the folders they change, and of the Inode they move, to the new value. An
+// entry stamped with the current clock is valid without looking further, so
+// a hit is one hash probe. Only after an rm, mv or recover is an entry's
+// chain up to the root walked, once: it is valid when no Inode on the chain
+// has a generation newer than its stamp, and is then stamped with the
+// current clock again. Entries are kept in least recently used order and the
+// oldest one is dropped when the cache is full.
+//
+#ifndef DENTRYCACHE_H
+#define DENTRYCACHE_H
+#include<cstdint>
+#include<string>
+#include "inode.hpp"
+#include "hash.hpp"
+#include "hashindex.hpp"
+#include "slabpool.hpp"
+using namespace std;
+
+class DentryCache
+{
+    private:
+        struct Entry
+        {
+            string path;            //the path as it was looked up
+            uint64_t path_hash;
+            Inode* node;            //what it resolved to
+            uint64_t stamp;         //generation clock when it was last known to be valid
+            Entry *prev, *next;     //neighbours in the LRU list, most recent first
+
+            Entry(const char* p, size_t length, uint64_t hash) : path(p, length), path_hash(hash), node(nullptr), stamp(0), prev(nullptr), next(nullptr) { }
+            const string& getName() const { return path; }
+            uint64_t getNameHash() const { return path_hash; }
+        };
+
+        HashIndex<Entry> entries;       //entries by path
+        SlabPool<Entry> pool;           //where the entries live
+        Entry *head, *tail;             //most and least recently used entries
+        size_t capacity;                //maximum number of entries
+        uint64_t hits, misses, prefix_hits, stale, evictions;   //statistics
+
+        void unlink(Entry* entry);
+        void pushFront(Entry* entry);
+        void drop(Entry* entry);                        //remove an entry from the index, the list and the pool
+        static bool valid(Entry* entry, Inode* root, uint64_t clock);
+
+        DentryCache(const DentryCache&);
+        DentryCache& operator=(const DentryCache&);
+    public:
+        DentryCache(size_t capacity = 4096);
+        Inode* lookup(const char* path, size_t length, Inode* root, uint64_t clock);       //a valid cached Inode for the path, or nullptr
+        Inode* lookupPrefix(const char* path, size_t& length, Inode* root, uint64_t clock); //the longest cached prefix ending before a '/', its length in length
+        void insert(const char* path, size_t length, Inode* node, uint64_t stamp);
+        void clear();                                   //drop every entry, when Inodes are destroyed
+        size_t size() const;
+        void printStats(ostream& out) const;
+};
+//================================================
+
+DentryCache::DentryCache(size_t capacity) : head(nullptr), tail(nullptr), capacity(capacity), hits(0), misses(0), prefix_hits(0), stale(0), evictions(0) {
+}
+
+void DentryCache::unlink(Entry* entry) {
+    (entry->prev != nullptr ? entry->prev->next : head) = entry->next;
+    (entry->next != nullptr ? entry->next->prev : tail) = entry->prev;
+    entry->prev = entry->next = nullptr;
+}
+
+void DentryCache::pushFront(Entry* entry) {
+    entry->next = head;
+    entry->prev = nullptr;
+    (head != nullptr ? head->prev : tail) = entry;
+    head = entry;
+}
+
+void DentryCache::drop(Entry* entry) {
+    unlink(entry);
+    entries.erase(entry);
+    pool.destroy(entry);
+}
+
+//create a method that checks that nothing on the chain from the Inode up to the root changed since the entry was last checked
+bool DentryCache::valid(Entry* entry, Inode* root, uint64_t clock) {
+    if (entry->stamp == clock) {
+        return true;//no rm, mv or recover since then
+    }
+    for (Inode* node = entry->node; node != nullptr; node = node->parent) {
+        if (node->generation > entry->stamp) {
+            return false;
+        }
+        if (node == root) {
+            entry->stamp = clock;
+            return true;
+        }
+    }
+    return false;//the chain does not reach the root, the Inode is in the bin
+}
+
+//create a method that looks a path up with one hash probe and moves a valid entry to the front
+Inode* DentryCache::lookup(const char* path, size_t length, Inode* root, uint64_t clock) {
+    Entry* entry = entries.find(path, length, hashBytes(path, length));
+    if (entry == nullptr) {
+        misses++;
+        return nullptr;
+    }
+    if (!valid(entry, root, clock)) {
+        stale++;
+        misses++;
+        drop(entry);
+        return nullptr;
+    }
+    hits++;
+    if (entry != head) {
+        unlink(entry);
+        pushFront(entry);
+    }
+    return entry->node;
+}
+
+//create a method that tries the prefixes of a path from the longest one down, so that only the rest has to be resolved
+Inode* DentryCache::lookupPrefix(const char* path, size_t& length, Inode* root, uint64_t clock) {
+    for (size_t end = length; end > 1; ) {
+        while (end > 1 && path[end - 1] != '/') {
+            end--;
+        }
+        while (end > 1 && path[end - 1] == '/') {
+            end--;
+        }
+        if (end <= 1) {
+            break;
+        }
+        Entry* entry = entries.find(path, end, hashBytes(path, end));
+        if (entry != nullptr && valid(entry, root, clock)) {
+            prefix_hits++;
+            if (entry != head) {
+                unlink(entry);
+                pushFront(entry);
+            }
+            length = end;
+            return entry->node;
+        }
+    }
+    return nullptr;
+}
+
+void DentryCache::insert(const char* path, size_t length, Inode* node, uint64_t stamp) {
+    uint64_t hash = hashBytes(path, length);
+    Entry* entry = entries.find(path, length, hash);
+    if (entry == nullptr) {
+        if (entries.size() >= capacity && tail != nullptr) {
+            drop(tail);
+            evictions++;
+        }
+        entry = pool.create(path, length, hash);
+        entries.insert(entry);
+    } else {
+        unlink(entry);
+    }
+    entry->node = node;
+    entry->stamp = stamp;
+    pushFront(entry);
+}
+
+void DentryCache::clear() {
+    entries.clear();
+    pool.reset();
+    head = tail = nullptr;
+}
+
+size_t DentryCache::size() const {
+    return entries.size();
+}
+
+void DentryCache::printStats(ostream& out) const {
+    uint64_t lookups = hits + misses;
+    out << "Entries    : " << entries.size() << " of " << capacity << endl;
+    out << "Hits       : " << hits << " (" << (lookups > 0 ? hits * 100 / lookups : 0) << "% of " << lookups << " lookups)" << endl;
+    out << "Misses     : " << misses << ", " << prefix_hits << " resolved from a cached prefix, " << stale << " stale" << endl;
+    out << "Evictions  : " << evictions << endl;
+}
+
+#endif
@@ -0,0 +1,645 @@
+//============================================================================
+// Name         : filestore.hpp
+// Author       : Aysa Binte masud
+// Version      : 01
+// Date Created : 17 October 2026
+// Date Modified: 17 October 2026
+// Description  : Extent-based block storage of file contents in C++
+//============================================================================
+//
+// The contents of files live in blocks of 4 KB of one host file, which grows
+// by regions of 64 MB, and are reached through a page cache of a fixed size
+// (pagecache.hpp), so contents larger than memory spill to the disk while
+// the Inodes stay in memory. A file holds a list of extents, runs of blocks
+// that follow each other, in file order. Free blocks are kept as extents
+// too, by first block (to merge a freed run with its neighbours) and by
+// length (for the best fit). A file that grows takes the blocks right after
+// its last extent when they are free, so a file written sequentially is a
+// few long extents, written back and read ahead with few system calls.
+// Every block is pinned in the cache while it is copied; a block that is
+// overwritten whole, or holds nothing stored yet, is not read first. Reads
+// hand each piece to a visitor while its page is pinned, without copying.
+// The bytes of a file past what its extents hold (a file made by touch, or
+// truncated to a larger size) read as zeros.
+//
+// Blocks are counted references, so the same block can be in the extents
+// of many files. A block written from its start to its end, or to the end
+// of the file, is indexed by a hash of its bytes; a later write of the same
+// bytes at the start of a block finds it, compares the bytes and refers to
+// it instead of storing them again, so identical files and identical parts
+// of files (the same template written for every tenant) take their blocks
+// once. A block is never changed while more than one file refers to it: a
+// write first gives the file a copy of its own, and takes it out of the
+// index. Contents are shared by the copies of a file until one of them
+// writes, which then gets extents of its own referring to the same blocks,
+// and the contents of a file in a mounted snapshot are read in place from
+// the mapping until it is written. Allocating, freeing, counting references
+// and the index take the store's own mutex; the bytes of a file are guarded
+// by the lock of its Inode.
+//
+#ifndef FILESTORE_H
+#define FILESTORE_H
+#include<cstdint>
+#include<cstring>
+#include<vector>
+#include<map>
+#include<set>
+#include<unordered_map>
+#include<mutex>
+#include<atomic>
+#include<algorithm>
+#include<iterator>
+#include<new>
+#include "slabpool.hpp"
+#include "pagecache.hpp"
+#include "hash.hpp"
+using namespace std;
+
+const uint64_t BLOCK_BYTES = PAGE_BYTES;    //unit of allocation
+const uint64_t REGION_BLOCKS = 16384;       //blocks the host file grows by, 64 MB
+
+//a run of blocks that follow each other in the host file
+struct Extent
+{
+    uint64_t offset;                //position in the file of its first byte, a multiple of BLOCK_BYTES
+    uint64_t block;                 //first block
+    uint64_t count;                 //number of blocks
+};
+
+//the contents of a file; copies of the file share them until one of them writes
+struct FileData
+{
+    atomic<uint32_t> refs;          //Inodes holding these contents
+    uint64_t stored;                //bytes held, the rest of the file's size reads as zeros
+    uint64_t blocks;                //blocks in the extents
+    const char* mapped;             //contents in a mounted snapshot, read in place; nullptr once they are in blocks
+    vector<Extent> extents;         //in file order
+
+    FileData() : refs(1), stored(0), blocks(0), mapped(nullptr) { }
+};
+
+//how much the blocks are shared
+struct DedupStats
+{
+    uint64_t referenced;            //references to blocks from the contents of files
+    uint64_t physical;              //blocks in use
+    uint64_t shared;                //blocks referred to more than once
+    uint64_t indexed;               //blocks that can be found by their bytes
+    uint64_t hits;                  //blocks written that were found stored already
+    uint64_t copies;                //shared blocks copied before a write
+};
+
+class FileStore
+{
+    private:
+        static const size_t MAX_REGIONS = 4096;     //256 GB of blocks
+        static const uint64_t READ_AHEAD = 31;      //blocks of the same extent read with a missing one
+
+        struct BlockInfo
+        {
+            uint64_t hash;              //of the first length bytes
+            uint32_t refs;              //extents that hold the block, 0 while it is free
+            uint32_t length;            //bytes the hash covers, 0 if the block is not in the index
+        };
+
+        PageCache cache;                //the blocks in memory
+        size_t region_count;            //the host file holds region_count * REGION_BLOCKS blocks
+        map<uint64_t, uint64_t> free_at;                //free extents, first block to number of blocks
+        set<pair<uint64_t, uint64_t> > free_by_size;    //the same as (number of blocks, first block)
+        uint64_t free_blocks;
+        vector<BlockInfo> info;         //of every block of the host file
+        unordered_map<uint64_t, uint64_t> by_hash;      //the blocks in the index, hash to block
+        uint64_t referenced, shared_blocks, hits, copies;
+        SlabPool<FileData> records;     //the contents of every file that has some
+        mutex lock;                     //guards the regions, the free extents, the blocks' references and index, and the records
+
+        void takeFree(uint64_t first, uint64_t count, uint64_t taken);     //use the first blocks of a free extent
+        void addFree(uint64_t first, uint64_t count);   //give back blocks, merged with free neighbours
+        bool addRegion();
+        void allocate(FileData* data, uint64_t blocks); //add blocks after the last extent of a file
+        void freeBlocks(FileData* data, uint64_t keep); //drop the references of a file to its blocks after the first keep
+        void unindex(uint64_t block);
+        void dropBlock(uint64_t block);                 //one reference less, the last one frees the block
+        uint64_t takeBlock();                           //a free block with one reference
+        static size_t extentAt(const FileData* data, uint64_t offset);     //the extent holding the byte at offset
+        static uint64_t setBlock(FileData* data, uint64_t index, uint64_t block);  //make block the index-th of a file, returns the one it was
+        uint64_t writable(FileData* data, uint64_t start, uint64_t block, bool fresh);  //the block at start, copied first if another file refers to it
+        uint64_t writeBlock(FileData* data, uint64_t offset, const char* bytes, uint64_t length);  //copy bytes (zeros if nullptr) into one block, returns it
+        bool shareSame(FileData* data, uint64_t start, const char* bytes, uint64_t length, uint64_t hash);    //refer to a stored block with the same bytes
+
+        //fn(pointer, length) for the piece of each block of a file in [offset, offset + length), with the block pinned
+        template <typename F>
+        void forRange(const FileData* data, uint64_t offset, uint64_t length, F fn);
+
+        FileStore(const FileStore&);
+        FileStore& operator=(const FileStore&);
+    public:
+        FileStore(const string& block_file = "vfs.blocks", uint64_t cache_bytes = DEFAULT_CACHE_BYTES);
+        ~FileStore();
+        FileData* create();                                 //empty contents held by one Inode
+        FileData* createMapped(const char* bytes, uint64_t length);    //contents read in place from a mapping
+        static FileData* share(FileData* data);             //one more Inode holds data
+        void release(FileData* data);                       //an Inode no longer holds data; the last one frees it
+        FileData* own(FileData* data, uint64_t keep);       //data if only one Inode holds it, otherwise a copy of its first keep bytes
+        void write(FileData* data, uint64_t offset, const char* bytes, size_t length);  //data must be owned
+        void truncate(FileData* data, uint64_t length);     //drop what is stored after length
+        //fn(pointer, length) for each piece of [offset, offset + length) of a file of that size, in order
+        template <typename F>
+        void read(const FileData* data, uint64_t size, uint64_t offset, uint64_t length, F fn);
+        void reset();                                       //drop every file's contents and empty the host file
+        bool setCacheSize(uint64_t bytes);                  //false while a page is pinned
+        CacheStats cacheStats();
+        DedupStats dedupStats();
+        size_t regionCount();
+        uint64_t usedBlocks();
+        uint64_t freeBlockCount();
+        size_t fileCount();                                 //contents held by one or more Inodes
+        size_t freeExtentCount();                           //runs of free blocks, a measure of fragmentation
+};
+//================================================
+
+const size_t FileStore::MAX_REGIONS;
+const uint64_t FileStore::READ_AHEAD;
+
+FileStore::FileStore(const string& block_file, uint64_t cache_bytes) : cache(block_file, cache_bytes), region_count(0), free_blocks(0), referenced(0), shared_blocks(0), hits(0), copies(0) {
+}
+
+FileStore::~FileStore() {
+    reset();
+}
+
+void FileStore::takeFree(uint64_t first, uint64_t count, uint64_t taken) {
+    free_at.erase(first);
+    free_by_size.erase(make_pair(count, first));
+    free_blocks -= taken;
+    for (uint64_t b = first; b < first + taken; ++b) {
+        info[b].refs = 1;
+    }
+    referenced += taken;
+    if (taken < count) {
+        free_at[first + taken] = count - taken;
+        free_by_size.insert(make_pair(count - taken, first + taken));
+    }
+}
+
+//create a method that returns blocks to the free extents, merging them with the free blocks on either side
+void FileStore::addFree(uint64_t first, uint64_t count) {
+    free_blocks += count;
+    map<uint64_t, uint64_t>::iterator next = free_at.lower_bound(first);
+    if (next != free_at.begin()) {
+        map<uint64_t, uint64_t>::iterator before = prev(next);
+        if (before->first + before->second == first) {
+            free_by_size.erase(make_pair(before->second, before->first));
+            first = before->first;
+            count += before->second;
+            free_at.erase(before);
+        }
+    }
+    if (next != free_at.end() && first + count == next->first) {
+        free_by_size.erase(make_pair(next->second, next->first));
+        count += next->second;
+        free_at.erase(next);
+    }
+    free_at[first] = count;
+    free_by_size.insert(make_pair(count, first));
+}
+
+//create a method that lengthens the host file by one region; its blocks take disk space as they are written back
+bool FileStore::addRegion() {
+    if (region_count == MAX_REGIONS) {
+        return false;
+    }
+    cache.grow((region_count + 1) * REGION_BLOCKS * BLOCK_BYTES);
+    BlockInfo free_block = {0, 0, 0};
+    info.resize((region_count + 1) * REGION_BLOCKS, free_block);
+    addFree(region_count * REGION_BLOCKS, REGION_BLOCKS);
+    region_count++;
+    return true;
+}
+
+//create a method that appends blocks to a file: the free blocks right after its last extent extend it, otherwise the smallest free extent that fits, or the largest one
+void FileStore::allocate(FileData* data, uint64_t blocks) {
+    lock_guard<mutex> guard(lock);
+    while (blocks > 0) {
+        if (!data->extents.empty()) {
+            Extent& last = data->extents.back();
+            uint64_t after = last.block + last.count;
+            map<uint64_t, uint64_t>::iterator next = free_at.find(after);
+            if (next != free_at.end()) {
+                uint64_t taken = min(blocks, next->second);
+                takeFree(next->first, next->second, taken);
+                last.count += taken;
+                data->blocks += taken;
+                blocks -= taken;
+                continue;
+            }
+        }
+        if (free_by_size.empty() && !addRegion()) {
+            throw bad_alloc();
+        }
+        set<pair<uint64_t, uint64_t> >::iterator fit = free_by_size.lower_bound(make_pair(blocks, (uint64_t)0));
+        if (fit == free_by_size.end()) {
+            --fit;//none is large enough, the largest is used and the rest comes from others
+        }
+        uint64_t first = fit->second, count = fit->first;
+        uint64_t taken = min(blocks, count);
+        takeFree(first, count, taken);
+        Extent extent = {data->blocks * BLOCK_BYTES, first, taken};
+        data->extents.push_back(extent);
+        data->blocks += taken;
+        blocks -= taken;
+    }
+}
+
+//create a method that drops the references of a file to its blocks after the first keep, from its last extent backwards; the blocks no other file refers to are freed
+void FileStore::freeBlocks(FileData* data, uint64_t keep) {
+    lock_guard<mutex> guard(lock);
+    while (data->blocks > keep) {
+        Extent& last = data->extents.back();
+        uint64_t drop = min(last.count, data->blocks - keep);
+        uint64_t first = last.block + last.count - drop, run = 0;//free blocks are given back in runs
+        for (uint64_t b = first; b < first + drop; ++b) {
+            BlockInfo& block = info[b];
+            referenced--;
+            if (--block.refs == 1) {
+                shared_blocks--;
+            }
+            if (block.refs > 0) {
+                if (run > 0) {
+                    addFree(b - run, run);
+                    cache.discard(b - run, run);
+                    run = 0;
+                }
+                continue;
+            }
+            unindex(b);
+            run++;
+        }
+        if (run > 0) {
+            addFree(first + drop - run, run);
+            cache.discard(first + drop - run, run);
+        }
+        last.count -= drop;
+        data->blocks -= drop;
+        if (last.count == 0) {
+            data->extents.pop_back();
+        }
+    }
+}
+
+void FileStore::unindex(uint64_t block) {
+    BlockInfo& b = info[block];
+    if (b.length == 0) {
+        return;
+    }
+    unordered_map<uint64_t, uint64_t>::iterator it = by_hash.find(b.hash);
+    if (it != by_hash.end() && it->second == block) {
+        by_hash.erase(it);
+    }
+    b.length = 0;
+}
+
+void FileStore::dropBlock(uint64_t block) {
+    lock_guard<mutex> guard(lock);
+    BlockInfo& b = info[block];
+    referenced--;
+    if (--b.refs == 1) {
+        shared_blocks--;
+    }
+    if (b.refs == 0) {
+        unindex(block);
+        addFree(block, 1);
+        cache.discard(block, 1);
+    }
+}
+
+uint64_t FileStore::takeBlock() {
+    lock_guard<mutex> guard(lock);
+    if (free_by_size.empty() && !addRegion()) {
+        throw bad_alloc();
+    }
+    set<pair<uint64_t, uint64_t> >::iterator smallest = free_by_size.begin();
+    uint64_t block = smallest->second;
+    takeFree(block, smallest->first, 1);
+    return block;
+}
+
+size_t FileStore::extentAt(const FileData* data, uint64_t offset) {
+    //the last extent that starts at or before offset
+    return upper_bound(data->extents.begin(), data->extents.end(), offset, [](uint64_t at, const Extent& e) { return at < e.offset; }) - data->extents.begin() - 1;
+}
+
+//create a method that puts another block at a position of a file, splitting the extent that held the old one
+uint64_t FileStore::setBlock(FileData* data, uint64_t index, uint64_t block) {
+    size_t k = extentAt(data, index * BLOCK_BYTES);
+    Extent extent = data->extents[k];
+    uint64_t i = index - extent.offset / BLOCK_BYTES;
+    uint64_t old = extent.block + i;
+    if (old == block) {
+        return old;
+    }
+    Extent pieces[3];
+    int n = 0;
+    if (i > 0) {
+        Extent before = {extent.offset, extent.block, i};
+        pieces[n++] = before;
+    }
+    Extent middle = {index * BLOCK_BYTES, block, 1};
+    pieces[n++] = middle;
+    if (i + 1 < extent.count) {
+        Extent after = {(index + 1) * BLOCK_BYTES, old + 1, extent.count - i - 1};
+        pieces[n++] = after;
+    }
+    data->extents[k] = pieces[0];
+    data->extents.insert(data->extents.begin() + k + 1, pieces + 1, pieces + n);
+    return old;
+}
+
+//create a method that makes the block at a position of a file its own before it is written: a block no other file refers to leaves the index, a shared one is copied first
+uint64_t FileStore::writable(FileData* data, uint64_t start, uint64_t block, bool fresh) {
+    {
+        lock_guard<mutex> guard(lock);
+        if (info[block].refs == 1) {
+            unindex(block);
+            return block;
+        }
+    }
+    //the copy is made before the shared block loses this reference, so it cannot be freed while it is read
+    uint64_t copy = takeBlock();
+    if (!fresh) {
+        PageCache::Page from = cache.pin(block, false, 0);
+        PageCache::Page to = cache.pin(copy, true, 0);
+        memcpy(to.data, from.data, BLOCK_BYTES);
+        cache.unpin(to, true);
+        cache.unpin(from, false);
+    }
+    setBlock(data, start / BLOCK_BYTES, copy);
+    dropBlock(block);
+    lock_guard<mutex> guard(lock);
+    copies++;
+    return copy;
+}
+
+uint64_t FileStore::writeBlock(FileData* data, uint64_t offset, const char* bytes, uint64_t length) {
+    uint64_t start = offset / BLOCK_BYTES * BLOCK_BYTES;
+    const Extent& extent = data->extents[extentAt(data, start)];
+    bool fresh = length == BLOCK_BYTES || start >= data->stored;
+    uint64_t block = writable(data, start, extent.block + (start - extent.offset) / BLOCK_BYTES, fresh);
+    PageCache::Page page = cache.pin(block, fresh, 0);
+    if (bytes != nullptr) {
+        memcpy(page.data + offset - start, bytes, length);
+    } else {
+        memset(page.data + offset - start, 0, length);
+    }
+    cache.unpin(page, true);
+    return block;
+}
+
+//create a method that looks a block's bytes up in the index and, if a stored block holds the same, makes it the file's block at start
+bool FileStore::shareSame(FileData* data, uint64_t start, const char* bytes, uint64_t length, uint64_t hash) {
+    uint64_t found;
+    {
+        lock_guard<mutex> guard(lock);
+        unordered_map<uint64_t, uint64_t>::iterator it = by_hash.find(hash);
+        if (it == by_hash.end() || info[it->second].length != length) {
+            return false;
+        }
+        //the reference is taken before the bytes are compared, so no other file can write the block meanwhile
+        found = it->second;
+        referenced++;
+        if (++info[found].refs == 2) {
+            shared_blocks++;
+        }
+    }
+    PageCache::Page page = cache.pin(found, false, 0);
+    bool same = memcmp(page.data, bytes, length) == 0;
+    cache.unpin(page, false);
+    if (!same) {//two contents with the same hash
+        dropBlock(found);
+        return false;
+    }
+
+    uint64_t index = start / BLOCK_BYTES;
+    if (index < data->blocks) {
+        dropBlock(setBlock(data, index, found));
+    } else if (!data->extents.empty() && data->extents.back().block + data->extents.back().count == found) {
+        data->extents.back().count++;
+        data->blocks++;
+    } else {
+        Extent extent = {start, found, 1};
+        data->extents.push_back(extent);
+        data->blocks++;
+    }
+    lock_guard<mutex> guard(lock);
+    hits++;
+    return true;
+}
+
+//create a method that pins the blocks of a range one after the other, reading ahead in the extent
+template <typename F>
+void FileStore::forRange(const FileData* data, uint64_t offset, uint64_t length, F fn) {
+    size_t k = extentAt(data, offset);
+    while (length > 0) {
+        const Extent& extent = data->extents[k++];
+        uint64_t i = (offset - extent.offset) / BLOCK_BYTES;
+        for (; i < extent.count && length > 0; ++i) {
+            uint64_t inside = offset - (extent.offset + i * BLOCK_BYTES);
+            uint64_t n = min(length, BLOCK_BYTES - inside);
+            PageCache::Page page = cache.pin(extent.block + i, false, min(READ_AHEAD, extent.count - i - 1));
+            try {
+                fn(page.data + inside, n);
+            } catch (...) {
+                cache.unpin(page, false);
+                throw;
+            }
+            cache.unpin(page, false);
+            offset += n;
+            length -= n;
+        }
+    }
+}
+
+FileData* FileStore::create() {
+    lock_guard<mutex> guard(lock);
+    return records.create();
+}
+
+FileData* FileStore::createMapped(const char* bytes, uint64_t length) {
+    FileData* data = create();
+    data->mapped = bytes;
+    data->stored = length;
+    return data;
+}
+
+FileData* FileStore::share(FileData* data) {
+    data->refs.fetch_add(1, memory_order_relaxed);
+    return data;
+}
+
+void FileStore::release(FileData* data) {
+    if (data->refs.fetch_sub(1, memory_order_acq_rel) != 1) {
+        return;
+    }
+    freeBlocks(data, 0);
+    lock_guard<mutex> guard(lock);
+    records.destroy(data);
+}
+
+//create a method that gives a writer contents of its own: the same ones if no other Inode holds them and they are in blocks, otherwise extents referring to the blocks of as much as the write keeps
+FileData* FileStore::own(FileData* data, uint64_t keep) {
+    if (data->refs.load(memory_order_acquire) == 1 && data->mapped == nullptr) {
+        return data;
+    }
+    FileData* copy = create();
+    keep = min(keep, data->stored);
+    if (keep > 0 && data->mapped != nullptr) {
+        write(copy, 0, data->mapped, keep);
+    } else if (keep > 0) {
+        uint64_t blocks = (keep + BLOCK_BYTES - 1) / BLOCK_BYTES;
+        lock_guard<mutex> guard(lock);
+        for (size_t k = 0; copy->blocks < blocks; ++k) {
+            Extent extent = data->extents[k];
+            extent.count = min(extent.count, blocks - copy->blocks);
+            for (uint64_t b = extent.block; b < extent.block + extent.count; ++b) {
+                if (++info[b].refs == 2) {
+                    shared_blocks++;
+                }
+            }
+            referenced += extent.count;
+            copy->extents.push_back(extent);
+            copy->blocks += extent.count;
+        }
+        copy->stored = keep;
+    }
+    release(data);
+    return copy;
+}
+
+//create a method that copies bytes into a file at offset block by block, zeroing a gap after what was stored; a block written from its start to its end or to the end of the file is shared with a stored block of the same bytes, or indexed
+void FileStore::write(FileData* data, uint64_t offset, const char* bytes, size_t length) {
+    uint64_t end = offset + length, blocks = (end + BLOCK_BYTES - 1) / BLOCK_BYTES;
+    uint64_t stored = max(data->stored, end);
+    const char* from = nullptr;//zeros for the gap, then the bytes
+    uint64_t at = min(data->stored, offset);
+    while (at < end) {
+        if (at == offset) {
+            from = bytes;
+        }
+        uint64_t start = at / BLOCK_BYTES * BLOCK_BYTES;
+        uint64_t n = min((from != nullptr ? end : offset) - at, start + BLOCK_BYTES - at);
+        if (from != nullptr && at == start && (n == BLOCK_BYTES || at + n >= stored)) {
+            uint64_t hash = hashBytes(from, n);
+            if (!shareSame(data, start, from, n, hash)) {
+                if (start >= data->blocks * BLOCK_BYTES) {
+                    allocate(data, blocks - data->blocks);
+                }
+                uint64_t block = writeBlock(data, at, from, n);
+                lock_guard<mutex> guard(lock);
+                if (by_hash.insert(make_pair(hash, block)).second) {
+                    info[block].hash = hash;
+                    info[block].length = n;
+                }
+            }
+        } else {
+            if (start >= data->blocks * BLOCK_BYTES) {
+                allocate(data, blocks - data->blocks);
+            }
+            writeBlock(data, at, from, n);
+        }
+        at += n;
+        if (from != nullptr) {
+            from += n;
+        }
+        data->stored = max(data->stored, at);
+    }
+}
+
+void FileStore::truncate(FileData* data, uint64_t length) {
+    if (length >= data->stored) {//a larger size is a hole of zeros, which takes no blocks
+        return;
+    }
+    data->stored = length;
+    freeBlocks(data, (length + BLOCK_BYTES - 1) / BLOCK_BYTES);
+}
+
+//create a method that hands the bytes of a range to fn in pieces from the pinned blocks or the mapping, and pieces of a zero block for the rest
+template <typename F>
+void FileStore::read(const FileData* data, uint64_t size, uint64_t offset, uint64_t length, F fn) {
+    static const char zeros[BLOCK_BYTES] = {0};
+    if (offset >= size) {
+        return;
+    }
+    length = min(length, size - offset);
+    uint64_t stored = data != nullptr ? min(data->stored, size) : 0;
+    if (offset < stored) {
+        uint64_t n = min(length, stored - offset);
+        if (data->mapped != nullptr) {
+            fn(data->mapped + offset, n);
+        } else {
+            forRange(data, offset, n, fn);
+        }
+        offset += n;
+        length -= n;
+    }
+    while (length > 0) {
+        uint64_t n = min(length, BLOCK_BYTES);
+        fn(zeros, n);
+        length -= n;
+    }
+}
+
+//create a method that drops every file's contents at once, when every Inode is destroyed
+void FileStore::reset() {
+    lock_guard<mutex> guard(lock);
+    records.reset();
+    cache.reset();
+    region_count = 0;
+    info.clear();
+    by_hash.clear();
+    referenced = shared_blocks = 0;
+    free_at.clear();
+    free_by_size.clear();
+    free_blocks = 0;
+}
+
+//create a method that changes the size of the page cache, writing back what it holds first
+bool FileStore::setCacheSize(uint64_t bytes) {
+    return cache.resize(bytes);
+}
+
+CacheStats FileStore::cacheStats() {
+    return cache.stats();
+}
+
+DedupStats FileStore::dedupStats() {
+    lock_guard<mutex> guard(lock);
+    DedupStats out = {referenced, region_count * REGION_BLOCKS - free_blocks, shared_blocks, by_hash.size(), hits, copies};
+    return out;
+}
+
+size_t FileStore::regionCount() {
+    lock_guard<mutex> guard(lock);
+    return region_count;
+}
+
+uint64_t FileStore::usedBlocks() {
+    lock_guard<mutex> guard(lock);
+    return region_count * REGION_BLOCKS - free_blocks;
+}
+
+uint64_t FileStore::freeBlockCount() {
+    lock_guard<mutex> guard(lock);
+    return free_blocks;
+}
+
+size_t FileStore::fileCount() {
+    lock_guard<mutex> guard(lock);
+    return records.liveCount();
+}
+
+size_t FileStore::freeExtentCount() {
+    lock_guard<mutex> guard(lock);
+    return free_at.size();
+}
+
+#endif
@@ -0,0 +1,58 @@
+//============================================================================
+// Name         : hash.hpp
+// Author       : Aysa Binte masud
+// Version      : 01
+// Date Created : 17 October 2026
+// Date Modified: 17 October 2026
+// Description  : Fast non-cryptographic hashing used by the VFS indexes
+//============================================================================
+#ifndef HASH_H
+#define HASH_H
+#include<cstdint>
+#include<cstring>
+#include<string>
+using namespace std;
+
+//final avalanche step so that every input bit affects every output bit
+inline uint64_t hashFinalize(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+//hash a block of bytes, consuming 8 bytes per round
+inline uint64_t hashBytes(const void* data, size_t len, uint64_t seed = 0x9E3779B97F4A7C15ULL) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    uint64_t h = seed ^ (len * 0x87c37b91114253d5ULL);
+
+    while (len >= 8) {//mix in one word at a time
+        uint64_t k;
+        memcpy(&k, p, 8);
+        k *= 0x87c37b91114253d5ULL;
+        k ^= k >> 31;
+        k *= 0x4cf5ad432745937fULL;
+        h ^= k;
+        h = ((h << 27) | (h >> 37)) * 5 + 0x52dce729;
+        p += 8;
+        len -= 8;
+    }
+
+    if (len > 0) {//the remaining 1..7 bytes
+        uint64_t k = 0;
+        memcpy(&k, p, len);
+        k *= 0x4cf5ad432745937fULL;
+        k ^= k >> 31;
+        h ^= k * 0x87c37b91114253d5ULL;
+    }
+    return hashFinalize(h);
+}
+
+//hash a name of a file or a folder
+inline uint64_t hashName(const string& name) {
+    return hashBytes(name.data(), name.size());
+}
+
+#endif
@@ -0,0 +1,274 @@
+//============================================================================
+// Name         : hashindex.hpp
+// Author       : Aysa Binte masud
+// Version      : 01
+// Date Created : 17 October 2026
+// Date Modified: 17 October 2026
+// Description  : Open addressing (Swiss table style) name index in C++
+//============================================================================
+//
+// The table keeps one control byte per slot next to an array of pointers.
+// A control byte is either EMPTY, DELETED or the low 7 bits of the hash of
+// the name stored in that slot. Slots are grouped 16 at a time so that one
+// SSE2 compare checks the tags of a whole group; only the slots whose tag
+// matches are compared by name. T must provide getName() and getNameHash().
+//
+#ifndef HASHINDEX_H
+#define HASHINDEX_H
+#include<cstdint>
+#include<cstring>
+#include<string>
+#if defined(__SSE2__)
+#include<emmintrin.h>
+#endif
+using namespace std;
+
+template <typename T>
+class HashIndex
+{
+    private:
+        static const int GROUP = 16;            //slots probed together
+        static const int8_t EMPTY = -128;       //control byte of an unused slot
+        static const int8_t DELETED = -2;       //control byte of an erased slot
+
+        int8_t *ctrl;                   //control bytes, one per slot
+        T **slots;                      //the stored items
+        size_t capacity;                //number of slots (a multiple of GROUP)
+        size_t used;                    //number of stored items
+        size_t deleted;                 //number of DELETED slots
+
+        static unsigned matchTag(const int8_t* group, int8_t tag);  //bitmask of the slots holding tag
+        static unsigned matchFree(const int8_t* group);             //bitmask of the EMPTY or DELETED slots
+        static unsigned matchEmpty(const int8_t* group);            //bitmask of the EMPTY slots
+        void rehash(size_t new_capacity);                           //move all items into a new table
+
+        HashIndex(const HashIndex&);
+        HashIndex& operator=(const HashIndex&);
+    public:
+        HashIndex();
+        ~HashIndex();
+        size_t size() const;                                //number of stored items
+        T* find(const string& name, uint64_t hash) const;   //returns the item with the given name or nullptr
+        T* find(const char* name, size_t length, uint64_t hash) const;
+        bool insert(T* item);                               //false if the name is already present
+        bool erase(T* item);                                //false if the item is not present
+        void clear();                                       //remove all items and release the memory
+        size_t memoryBytes() const;                         //memory held by the table
+};
+//================================================
+
+#if defined(__SSE2__)
+template <typename T>
+unsigned HashIndex<T>::matchTag(const int8_t* group, int8_t tag) {
+    __m128i g = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_set1_epi8(tag)));
+}
+
+template <typename T>
+unsigned HashIndex<T>::matchFree(const int8_t* group) {
+    //EMPTY and DELETED are the only control bytes with the sign bit set
+    return _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(group)));
+}
+#else
+template <typename T>
+unsigned HashIndex<T>::matchTag(const int8_t* group, int8_t tag) {
+    unsigned mask = 0;
+    for (int i = 0; i < GROUP; ++i) {
+        if (group[i] == tag) mask |= 1u << i;
+    }
+    return mask;
+}
+
+template <typename T>
+unsigned HashIndex<T>::matchFree(const int8_t* group) {
+    unsigned mask = 0;
+    for (int i = 0; i < GROUP; ++i) {
+        if (group[i] < 0) mask |= 1u << i;
+    }
+    return mask;
+}
+#endif
+
+template <typename T>
+unsigned HashIndex<T>::matchEmpty(const int8_t* group) {
+    return matchTag(group, EMPTY);
+}
+
+//constructor for an empty index, the table is allocated on the first insert
+template <typename T>
+HashIndex<T>::HashIndex() : ctrl(nullptr), slots(nullptr), capacity(0), used(0), deleted(0) {
+}
+
+//destructor for freeing up the table, the items themselves are not owned
+template <typename T>
+HashIndex<T>::~HashIndex() {
+    delete[] ctrl;
+    delete[] slots;
+}
+
+template <typename T>
+size_t HashIndex<T>::size() const {
+    return used;
+}
+
+//probe the groups of the name's hash until the name is found or a group with an EMPTY slot ends the search
+template <typename T>
+T* HashIndex<T>::find(const string& name, uint64_t hash) const {
+    return find(name.data(), name.size(), hash);
+}
+
+//the same lookup for a name that is not held in a string, such as a path component
+template <typename T>
+T* HashIndex<T>::find(const char* name, size_t length, uint64_t hash) const {
+    if (capacity == 0) {
+        return nullptr;
+    }
+
+    size_t mask = capacity / GROUP - 1;
+    size_t group = (hash >> 7) & mask;
+    int8_t tag = static_cast<int8_t>(hash & 0x7F);
+
+    for (size_t step = 1; step <= mask + 1; ++step) {
+        const int8_t* c = ctrl + group * GROUP;
+        for (unsigned m = matchTag(c, tag); m != 0; m &= m - 1) {
+            T* item = slots[group * GROUP + __builtin_ctz(m)];
+            if (item->getNameHash() == hash && item->getName().size() == length && memcmp(item->getName().data(), name, length) == 0) {
+                return item;
+            }
+        }
+        if (matchEmpty(c) != 0) {//the name would have been placed in this group
+            return nullptr;
+        }
+        group = (group + step) & mask;//triangular probing visits every group once
+    }
+    return nullptr;
+}
+
+//add an item, keeping the load (including DELETED slots) under 7/8
+template <typename T>
+bool HashIndex<T>::insert(T* item) {
+    if ((used + deleted + 1) * 8 > capacity * 7) {
+        //grow if the table is really full, otherwise just drop the tombstones
+        rehash(used * 2 >= capacity ? (capacity == 0 ? GROUP : capacity * 2) : capacity);
+    }
+
+    uint64_t hash = item->getNameHash();
+    size_t mask = capacity / GROUP - 1;
+    size_t group = (hash >> 7) & mask;
+    int8_t tag = static_cast<int8_t>(hash & 0x7F);
+    size_t target = capacity;//first free slot seen along the probe sequence
+
+    for (size_t step = 1; step <= mask + 1; ++step) {
+        const int8_t* c = ctrl + group * GROUP;
+        for (unsigned m = matchTag(c, tag); m != 0; m &= m - 1) {
+            T* other = slots[group * GROUP + __builtin_ctz(m)];
+            if (other->getNameHash() == hash && other->getName() == item->getName()) {
+                return false;//the name is already taken
+            }
+        }
+        unsigned free_mask = matchFree(c);
+        if (target == capacity && free_mask != 0) {
+            target = group * GROUP + __builtin_ctz(free_mask);
+        }
+        if (matchEmpty(c) != 0) {
+            break;
+        }
+        group = (group + step) & mask;
+    }
+
+    if (ctrl[target] == DELETED) {
+        deleted--;
+    }
+    ctrl[target] = tag;
+    slots[target] = item;
+    used++;
+    return true;
+}
+
+//remove an item; its slot becomes EMPTY when no probe sequence can run past its group
+template <typename T>
+bool HashIndex<T>::erase(T* item) {
+    if (capacity == 0) {
+        return false;
+    }
+
+    uint64_t hash = item->getNameHash();
+    size_t mask = capacity / GROUP - 1;
+    size_t group = (hash >> 7) & mask;
+    int8_t tag = static_cast<int8_t>(hash & 0x7F);
+
+    for (size_t step = 1; step <= mask + 1; ++step) {
+        int8_t* c = ctrl + group * GROUP;
+        for (unsigned m = matchTag(c, tag); m != 0; m &= m - 1) {
+            size_t slot = group * GROUP + __builtin_ctz(m);
+            if (slots[slot] == item) {
+                if (matchEmpty(c) != 0) {
+                    ctrl[slot] = EMPTY;
+                } else {
+                    ctrl[slot] = DELETED;
+                    deleted++;
+                }
+                used--;
+                return true;
+            }
+        }
+        if (matchEmpty(c) != 0) {
+            return false;
+        }
+        group = (group + step) & mask;
+    }
+    return false;
+}
+
+//drop all items and release the table
+template <typename T>
+void HashIndex<T>::clear() {
+    delete[] ctrl;
+    delete[] slots;
+    ctrl = nullptr;
+    slots = nullptr;
+    capacity = used = deleted = 0;
+}
+
+template <typename T>
+size_t HashIndex<T>::memoryBytes() const {
+    return capacity * (sizeof(int8_t) + sizeof(T*));
+}
+
+//re-insert every item into a fresh table of the given capacity
+template <typename T>
+void HashIndex<T>::rehash(size_t new_capacity) {
+    int8_t* old_ctrl = ctrl;
+    T** old_slots = slots;
+    size_t old_capacity = capacity;
+
+    capacity = new_capacity;
+    ctrl = new int8_t[capacity];
+    slots = new T*[capacity];
+    memset(ctrl, EMPTY, capacity);
+    deleted = 0;
+
+    size_t mask = capacity / GROUP - 1;
+    for (size_t i = 0; i < old_capacity; ++i) {
+        if (old_ctrl[i] < 0) {
+            continue;
+        }
+        uint64_t hash = old_slots[i]->getNameHash();
+        size_t group = (hash >> 7) & mask;
+        for (size_t step = 1; ; ++step) {//names are unique, so take the first free slot
+            unsigned free_mask = matchFree(ctrl + group * GROUP);
+            if (free_mask != 0) {
+                size_t slot = group * GROUP + __builtin_ctz(free_mask);
+                ctrl[slot] = old_ctrl[i];
+                slots[slot] = old_slots[i];
+                break;
+            }
+            group = (group + step) & mask;
+        }
+    }
+
+    delete[] old_ctrl;
+    delete[] old_slots;
+}
+
+#endif
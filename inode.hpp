@@ -3,7 +3,7 @@
 // Author       : Aysa Binte masud
 // Version      : 01
 // Date Created : 10 November 2023
-// Date Modified: 15 November 2023
+// Date Modified: 17 October 2026
 // Description  : Inode implmentation in C++
 //============================================================================
 #ifndef INODE_H
@@ -14,95 +14,198 @@
 #include<ctime>
 #include<sstream>
 #include<vector>
+#include<atomic>
 #include "vector.hpp"
+#include "hash.hpp"
+#include "hashindex.hpp"
+#include "orderedindex.hpp"
+#include "rwlock.hpp"
 
 
 using namespace std;
 enum {File=0,Folder=1};
+//format a creation time the way ls prints it
+inline string formatTime(int64_t epoch) {
+	time_t t = static_cast<time_t>(epoch);
+	tm localTime;
+	localtime_r(&t, &localTime);//to convert it to the local time, without the static buffer other sessions share
+	char formattedTime[32];
+	strftime(formattedTime, sizeof(formattedTime), "%Y-%m-%d %H:%M:%S", &localTime);//writes in year, month, day, hour, minute, and second
+	return string(formattedTime);
+}
+
+//a number that no other Inode has had, so a handle (pointer and number) cannot be fooled by a recycled slot
+inline uint64_t nextInodeNumber() {
+	static atomic<uint64_t> counter(0);
+	return ++counter;
+}
+
+const uint64_t FOLDER_SIZE = 10;	//size of an empty folder, a folder's size is this plus the sizes of its children
+const int ORDERED_MIN = 64;			//a folder keeps its children sorted by name once it has this many
+
+class Inode;
+struct FileData;
+
+//supplies the children of an Inode that have not been materialized yet (for example from a mapped snapshot)
+class ChildSource
+{
+	public:
+		virtual void expand(Inode* node) = 0;	//create the children of node
+		virtual void share(Inode* copy, Inode* original) = 0;	//copy gets the children original has not materialized yet
+		virtual Inode* origin(Inode* /*node*/) { return nullptr; }	//a materialized folder whose children stand for node's, if there is one
+		virtual ~ChildSource() { }
+};
 
 class Inode
 {
 	private:
 		string name;				//name of the Inode
+		uint64_t name_hash;			//hash of the name, used by the child index
 		bool type;					//type of the Inode 0 for File 1 for Folder
-		unsigned int size;			//size of current Inode
-		string cr_time; 			//time of creation
+		atomic<uint64_t> size;		//size of current Inode (for a folder, the aggregate of its subtree), updated by concurrent sessions
+		int64_t cr_time; 			//time of creation (seconds since the epoch)
+		uint32_t table_index;		//position of the Inode in the last InodeTable built from the tree
+		uint32_t name_slot;			//position of the Inode in its bucket of the global name index
+		uint64_t generation;		//clock value of the last rm, mv or recover that changed this Inode or its children
+		uint64_t ino;				//unique number of the Inode
+		uint32_t depth;				//number of folders above it, counted where it was last attached
+		uint32_t bin_holds;			//bin items removed from this folder or below it whose path is read through their folder
 		
 		Vector<Inode*> children;	//Children of Inode
+		HashIndex<Inode> index;		//Children of Inode hashed by name
+		OrderedIndex<Inode>* ordered;	//Children of Inode sorted by name, nullptr in small folders
 		Inode* parent; 				//link to the parent 
+		ChildSource* lazy;			//where the children still have to come from, nullptr once they are in children
+		uint32_t lazy_index;		//position of this Inode in that source
+		uint32_t child_slot;		//position of this Inode in the children of its parent
+		FileData* data;				//contents of a file, nullptr while it has none (its size reads as zeros)
+		SpinRWLock dir_lock;		//held shared to read the children (or a file's contents), exclusively to change them
+
+		// Materialize the children before they are first used
+		void ensureChildren() {
+			if (lazy != nullptr) {
+				ChildSource* source = lazy;
+				lazy = nullptr;
+				source->expand(this);
+			}
+		}
 
 	public:
 		//constructor for initializing the attributes
-		Inode(string name, Inode* parent, bool type, int size, string cr_time) : name(name),type(type),size(size),cr_time(cr_time),parent(parent)
+		Inode(string name, Inode* parent, bool type, uint64_t size, int64_t cr_time) : name(name),name_hash(hashName(name)),type(type),size(size),cr_time(cr_time),table_index(0),name_slot(0),generation(0),ino(nextInodeNumber()),depth(parent != nullptr ? parent->depth + 1 : 0),bin_holds(0),ordered(nullptr),parent(parent),lazy(nullptr),lazy_index(0),child_slot(0),data(nullptr)
 		{ }
 
 		//declare the friend classes
-		template <typename U>
+		template <typename U, int M>
 		friend class Vector;
 		friend class VFS;
+		friend class InodeTable;
+		friend class MappedSnapshot;
+		friend class NameIndex;
+		friend class DentryCache;
+		friend class CloneSource;
 
 		// Getter methods
-	    string getName() const { return name; }//for the name
+	    const string& getName() const { return name; }//for the name
+	    uint64_t getNameHash() const { return name_hash; }//for the hash of the name
 	    bool getType() const { return type; }// for the type: file or folder
-	    unsigned int getSize() const { return size; }// for the size
-	    string getCreationTime() const { return cr_time; }// for the creation time
+	    uint64_t getSize() const { return size.load(memory_order_relaxed); }// for the size
+	    string getCreationTime() const { return formatTime(cr_time); }// for the creation time, formatted only when it is printed
+	    int64_t getCreationEpoch() const { return cr_time; }// for the creation time as stored
 	    Inode* getParent() const { return parent; }// for the parent of that inode
-	    Vector<Inode*>& getChildren() { return children; }//a vector containing all the children of the given inodee
-	    void setSize(unsigned int i){size=i;}// as setter method for updating the private attribute size
+	    uint64_t getIno() const { return ino; }// for the unique number
+	    uint32_t getDepth() const { return depth; }// for the number of folders above it
+	    bool isLazy() const { return lazy != nullptr; }// true while the children are not materialized
+	    Vector<Inode*>& getChildren() { ensureChildren(); return children; }//a vector containing all the children of the given inodee
+	    void setSize(uint64_t i){size.store(i, memory_order_relaxed);}// as setter method for updating the private attribute size
+	    void addSize(int64_t delta){size.fetch_add(static_cast<uint64_t>(delta), memory_order_relaxed);}// add a difference without losing a concurrent one
 
-	    // Method to add a child Inode
-	    void addChild(Inode* child) {
+	    // Method to add a child Inode, returns false if it could not be added
+	    bool addChild(Inode* child) {
 	    	//if it is a folder, add the child, otherwise, show an error message
-	        if (type == Folder) {
-	            children.push_back(child);
-	        } else {
+	        if (type != Folder) {
 	            cout << "Cannot add children to a File Inode." << endl;
+	            return false;
+	        }
+	        ensureChildren();
+	        //the index rejects a second child with the same name
+	        if (!index.insert(child)) {
+	            cout << "'" << child->getName() << "' already exists." << endl;
+	            return false;
+	        }
+	        child->child_slot = children.size();
+	        children.push_back(child);
+	        if (ordered != nullptr) {
+	            ordered->insert(child);
+	        } else if (children.size() >= ORDERED_MIN) {//the folder has become large enough to keep sorted
+	            ordered = new OrderedIndex<Inode>();
+	            for (int i = 0; i < children.size(); ++i) {
+	                ordered->insert(children[i]);
+	            }
 	        }
+	        return true;
 	    }
 
-	    // Method to remove a child Inode
-	    void removeChild(string childName) {
-
-	    	//traverse through all the children inodes
-	        for (size_t i = 0; i < children.size(); ++i) {
-	            if (children[i]->getName() == childName) {// if the given name matches the name of the child 
-	                delete children[i]; // Free memory associated with the Inode
-	                children.erase(i);// delete that from the vector as well
-	                return;
+	    // Method to remove a child Inode, the caller takes over the removed Inode
+	    Inode* removeChild(const string& childName) {
+	        ensureChildren();
+	        Inode* child = index.find(childName, hashName(childName));
+	        if (child == nullptr) {
+	            cout << "Child with name '" << childName << "' not found." << endl;
+	            return nullptr;
+	        }
+	        index.erase(child);
+	        if (ordered != nullptr) {
+	            ordered->erase(child);
+	            if (ordered->size() < ORDERED_MIN / 2) {//small again, sorting a copy is cheaper than the index
+	                delete ordered;
+	                ordered = nullptr;
 	            }
 	        }
-	        cout << "Child with name '" << childName << "' not found." << endl;
+
+	    	//the last child takes its place in the vector, so no other child moves
+	        int slot = child->child_slot;
+	        children.swap_erase(slot);
+	        if (slot < children.size()) {
+	            children[slot]->child_slot = slot;
+	        }
+	        return child;
+	    }
+
+	    // Method to look up a child Inode by name without printing anything
+	    Inode* lookupChild(const string& childName) {
+	        ensureChildren();
+	        return index.find(childName, hashName(childName));
+	    }
+	    Inode* lookupChild(const char* childName, size_t length) {
+	        ensureChildren();
+	        return index.find(childName, length, hashBytes(childName, length));
 	    }
 
 	    // Method to find a child Inode by name
-	    Inode* findChild(string childName) {
-	    	//traverse through all the children inodes
-	        for (size_t i = 0; i < children.size(); ++i) {
-	        	// if the given name matches the name of the child 
-	            if (children[i]->getName() == childName) {
-	                return children[i];// return the child
-	            }
-	        }
+	    Inode* findChild(const string& childName) {
+	        Inode* child = lookupChild(childName);
 	        //error message if child not found
-	        cout << "Child with name '" << childName << "' not found." << endl;
-	        return nullptr;
+	        if (child == nullptr) {
+	            cout << "Child with name '" << childName << "' not found." << endl;
+	        }
+	        return child;
 	    }
 
 	    // Method to display children of the Inode
 	    void displayChildren() {
+	        ensureChildren();
 	        cout << "Children of Inode '" << name << "':" << endl;
 	        for (size_t i = 0; i < children.size(); ++i) {
 	            cout << children[i]->getName() << endl;
 	        }
 	    }
 
-	    // Destructor to free memory of children
-	    ~Inode() {
-	    	//traverse through all the children inodes
-	        for (size_t i = 0; i < children.size(); ++i) {
-	            delete children[i];//delete the children
-	        }
-	    }
+	    // Method to get the children sorted by name, nullptr while the folder is small
+	    const OrderedIndex<Inode>* getOrdered() { ensureChildren(); return ordered; }
+
+	    // The children are owned by the VFS's Inode arena, which frees them (see VFS::purgeStep)
+	    ~Inode() { delete ordered; }
 };
 
 #endif
\ No newline at end of file
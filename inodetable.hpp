@@ -0,0 +1,399 @@
+//============================================================================
+// Name         : inodetable.hpp
+// Author       : Aysa Binte masud
+// Version      : 01
+// Date Created : 17 October 2026
+// Date Modified: 17 October 2026
+// Description  : Structure-of-arrays Inode table in C++
+//============================================================================
+//
+// The table stores the tree in preorder, one entry per Inode, with every
+// attribute in its own array: parent index, end of subtree, type, size,
+// creation time and the offset of the name in a shared string pool. Because
+// a subtree occupies the contiguous range [i, end[i]), searching names and
+// writing the tree are plain linear scans. Detached
+// subtrees, such as the items in the bin, can be laid out after the tree
+// as extra roots; they are kept out of the searches. A copy that was not
+// expanded yet is laid out from the children of the folder it copies, so
+// the table holds the tree as it reads without creating its Inodes. The
+// contents of the files are not copied: the table points at them, and a
+// save writes them after the columns through a BlockWriter.
+// A background checkpoint lays the table out a slice at a time with
+// buildSlice: between two slices the tree may change, so the cursor keeps
+// positions (the entry of each open folder and its next child) rather than
+// Inodes, and the next slice finds the open folders again from the top.
+// What it lays out is a copy that does not change (clone.hpp), so the
+// positions still point at the same children.
+//
+#ifndef INODETABLE_H
+#define INODETABLE_H
+#include<iostream>
+#include<cstdint>
+#include<cstring>
+#include<ctime>
+#include<string>
+#include<vector>
+#include<cstdio>
+#include<algorithm>
+#include "inode.hpp"
+#include "snapshot.hpp"
+#include "treewalk.hpp"
+#include "filestore.hpp"
+#include "blockwriter.hpp"
+using namespace std;
+
+//where a build done in slices stopped: the next subtree to start and, for each open folder, its entry and the position of its next child
+struct TableCursor
+{
+    size_t top;                                 //the tree is subtree 0, the detached ones follow
+    vector<pair<uint32_t, uint32_t> > open;
+
+    TableCursor() : top(0) { }
+};
+
+class InodeTable
+{
+    private:
+        vector<uint32_t> parent;        //index of the parent, NONE for the root
+        vector<uint32_t> end;           //one past the last index of the subtree
+        vector<uint8_t> type;           //File or Folder
+        vector<uint64_t> size;          //size of the Inode (the aggregate for folders)
+        vector<int64_t> cr_time;        //creation time in seconds since the epoch
+        vector<uint32_t> name_off;      //name i is names[name_off[i] .. name_off[i+1])
+        vector<char> names;             //string pool holding all the names
+        vector<uint32_t> extra;         //indices of the extra roots after the tree
+        vector<const FileData*> data;   //contents of each file, nullptr if it has none
+
+        void add(Inode* node, uint32_t parent_index);   //append the entry of node
+        void closeRanges();                             //fix the ends of the subtrees once every entry is in
+    public:
+        static const uint32_t NONE = 0xFFFFFFFF;
+
+        void build(Inode* root, const vector<Inode*>& detached = vector<Inode*>()); //lay out root's subtree, then the detached ones
+        template <typename Children>
+        bool buildSlice(const vector<Inode*>& tops, Children children, size_t budget, TableCursor& cursor); //lay out up to budget more entries of the tops, true once all are in
+        void clear();                                   //drop all entries
+        void reserve(size_t entries, size_t name_bytes);    //room for a build of about that size, so it does not grow as it goes
+        uint32_t count() const;                         //number of entries
+        uint32_t getParent(uint32_t i) const;
+        uint32_t getEnd(uint32_t i) const;
+        bool getType(uint32_t i) const;
+        uint64_t getSize(uint32_t i) const;
+        int64_t getCreationEpoch(uint32_t i) const;
+        string getName(uint32_t i) const;
+        void findName(const string& name, vector<uint32_t>& hits) const; //entries called name, except the root
+        string path(uint32_t i) const;                  //absolute path of entry i
+        void write(ostream& out, uint32_t i) const;     //write the subtree of entry i, one path,size,date line per entry
+        size_t memoryBytes() const;                     //memory held by the arrays and the pool
+        bool save(const string& filename, FileStore& files, const vector<SnapshotBinItem>& extra_items = vector<SnapshotBinItem>(), uint64_t bin_next_id = 1, uint64_t journal_sequence = 0) const; //write the table and the contents as a snapshot file
+};
+//================================================
+
+const uint32_t InodeTable::NONE;
+
+//create a method that copies the tree into the arrays with walkTree, so a deep tree needs no recursion
+void InodeTable::build(Inode* root, const vector<Inode*>& detached) {
+    clear();
+    if (root == nullptr) {
+        return;
+    }
+
+    //the folders whose children are being laid out, with their index; under a copy the entries are not the Inodes' own
+    struct Open { Inode* node; uint32_t index; bool through; };
+    vector<Open> open;
+    size_t copies = 0;//open folders that show the children of what they copy
+    for (size_t k = 0; k <= detached.size(); ++k) {//the whole tree first, then the detached subtrees in order
+        Inode* top = k == 0 ? root : detached[k - 1];
+        walkTree(top, [&](Inode* node) -> Vector<Inode*>* {
+            uint32_t index = parent.size();
+            if (copies == 0) {//the entry of an Inode is where it is in the tree, not where a copy shows it
+                node->table_index = index;
+            }
+            add(node, open.empty() ? NONE : open.back().index);
+
+            Inode* origin = node->lazy != nullptr ? node->lazy->origin(node) : nullptr;
+            Vector<Inode*>& children = origin != nullptr ? origin->children : node->getChildren();
+            if (children.size() == 0) {
+                return nullptr;
+            }
+            Open folder = {node, index, origin != nullptr};
+            open.push_back(folder);
+            copies += folder.through;
+            return &children;
+        }, [&](Inode* node) {
+            if (!open.empty() && open.back().node == node) {
+                copies -= open.back().through;
+                open.pop_back();
+            }
+        });
+    }
+    closeRanges();
+}
+
+void InodeTable::add(Inode* node, uint32_t parent_index) {
+    uint32_t index = parent.size();
+    if (index != 0 && parent_index == NONE) {
+        extra.push_back(index);
+    }
+    parent.push_back(parent_index);
+    end.push_back(index + 1);
+    type.push_back(node->getType());
+    size.push_back(node->getSize());
+    cr_time.push_back(node->getCreationEpoch());
+    data.push_back(node->data);
+    name_off.push_back(names.size());
+    names.insert(names.end(), node->getName().begin(), node->getName().end());
+}
+
+void InodeTable::closeRanges() {
+    name_off.push_back(names.size());
+
+    //children come after their parent, so one backwards pass closes every subtree range
+    for (uint32_t i = parent.size() - 1; i > 0; --i) {
+        if (parent[i] != NONE && end[i] > end[parent[i]]) {
+            end[parent[i]] = end[i];
+        }
+    }
+}
+
+//create a method that continues a build where the cursor stopped; children(node) gives the children node shows, and the caller starts from a cleared table
+template <typename Children>
+bool InodeTable::buildSlice(const vector<Inode*>& tops, Children children, size_t budget, TableCursor& cursor) {
+    //the open folders are found again by position, from the top being laid out down
+    vector<Vector<Inode*>*> lists;
+    if (!cursor.open.empty()) {
+        Inode* node = tops[cursor.top - 1];
+        for (size_t j = 0; ; ++j) {
+            lists.push_back(children(node));
+            if (j + 1 == cursor.open.size()) {
+                break;
+            }
+            node = (*lists.back())[cursor.open[j].second - 1];
+        }
+    }
+
+    //the Inode just added, and the children it shows if it is a folder that has some
+    auto shown = [&children](Inode* node) -> Vector<Inode*>* {
+        if (node->getType() != Folder) {
+            return nullptr;
+        }
+        Vector<Inode*>* list = children(node);
+        return list->size() > 0 ? list : nullptr;
+    };
+    for (; budget > 0; --budget) {
+        if (cursor.open.empty()) {
+            if (cursor.top == tops.size()) {
+                closeRanges();
+                return true;
+            }
+            Inode* top = tops[cursor.top++];
+            uint32_t index = parent.size();
+            add(top, NONE);
+            Vector<Inode*>* list = shown(top);
+            if (list != nullptr) {
+                cursor.open.push_back(make_pair(index, 0u));
+                lists.push_back(list);
+            }
+            continue;
+        }
+        pair<uint32_t, uint32_t>& folder = cursor.open.back();
+        Vector<Inode*>* list = lists.back();
+        if (folder.second == static_cast<uint32_t>(list->size())) {
+            cursor.open.pop_back();
+            lists.pop_back();
+            ++budget;//closing a folder adds no entry
+            continue;
+        }
+        Inode* child = (*list)[folder.second++];
+        uint32_t index = parent.size();
+        add(child, folder.first);
+        Vector<Inode*>* below = shown(child);
+        if (below != nullptr) {
+            cursor.open.push_back(make_pair(index, 0u));
+            lists.push_back(below);
+        }
+    }
+    return false;
+}
+
+void InodeTable::clear() {
+    parent.clear();
+    end.clear();
+    type.clear();
+    size.clear();
+    cr_time.clear();
+    name_off.clear();
+    names.clear();
+    extra.clear();
+    data.clear();
+}
+
+void InodeTable::reserve(size_t entries, size_t name_bytes) {
+    parent.reserve(entries);
+    end.reserve(entries);
+    type.reserve(entries);
+    size.reserve(entries);
+    cr_time.reserve(entries);
+    name_off.reserve(entries + 1);
+    names.reserve(name_bytes);
+    data.reserve(entries);
+}
+
+uint32_t InodeTable::count() const {
+    return parent.size();
+}
+
+uint32_t InodeTable::getParent(uint32_t i) const {
+    return parent[i];
+}
+
+uint32_t InodeTable::getEnd(uint32_t i) const {
+    return end[i];
+}
+
+bool InodeTable::getType(uint32_t i) const {
+    return type[i];
+}
+
+uint64_t InodeTable::getSize(uint32_t i) const {
+    return size[i];
+}
+
+int64_t InodeTable::getCreationEpoch(uint32_t i) const {
+    return cr_time[i];
+}
+
+string InodeTable::getName(uint32_t i) const {
+    return string(names.data() + name_off[i], name_off[i + 1] - name_off[i]);
+}
+
+//create a method that scans the name column of the tree, comparing lengths before bytes
+void InodeTable::findName(const string& name, vector<uint32_t>& hits) const {
+    uint32_t last = parent.empty() ? 0 : end[0];
+    for (uint32_t i = 1; i < last; ++i) {
+        if (name_off[i + 1] - name_off[i] == name.size() && memcmp(names.data() + name_off[i], name.data(), name.size()) == 0) {
+            hits.push_back(i);
+        }
+    }
+}
+
+//create a method that builds the path of an entry by following the parent column
+string InodeTable::path(uint32_t i) const {
+    if (i == 0) {
+        return "/";
+    }
+    vector<uint32_t> chain;
+    for (uint32_t j = i; j != 0; j = parent[j]) {
+        chain.push_back(j);
+    }
+
+    string result;
+    for (int k = chain.size() - 1; k >= 0; --k) {
+        result += '/';
+        result.append(names.data() + name_off[chain[k]], name_off[chain[k] + 1] - name_off[chain[k]]);
+    }
+    return result;
+}
+
+//create a method that writes a subtree in preorder, which is simply the range [i, end[i]), as path,size,date lines
+void InodeTable::write(ostream& out, uint32_t i) const {
+    //the path of the previous entry and, for each open folder, the end of its range and the length of its path
+    string base = (i == 0 || parent[i] == 0 || parent[i] == NONE) ? "" : path(parent[i]);
+    string line = base;
+    vector<pair<uint32_t, size_t> > open_folders;
+    char date[32];
+
+    for (uint32_t j = i; j < end[i]; ++j) {
+        while (!open_folders.empty() && j >= open_folders.back().first) {
+            open_folders.pop_back();
+        }
+        line.resize(open_folders.empty() ? base.size() : open_folders.back().second);
+        if (j != 0) {
+            line += '/';
+            line.append(names.data() + name_off[j], name_off[j + 1] - name_off[j]);
+        }
+        if (type[j] == Folder) {
+            open_folders.push_back(make_pair(end[j], line.size()));
+        }
+
+        time_t t = static_cast<time_t>(cr_time[j]);
+        strftime(date, sizeof(date), "%d-%m-%y %H:%M:%S", localtime(&t));
+        out << (j == 0 ? "/" : line) << (type[j] == Folder && j != 0 ? "/" : "") << "," << size[j] << "," << date << "\n";
+    }
+}
+
+size_t InodeTable::memoryBytes() const {
+    return parent.capacity() * sizeof(uint32_t) + end.capacity() * sizeof(uint32_t) + type.capacity() * sizeof(uint8_t)
+         + size.capacity() * sizeof(uint64_t) + cr_time.capacity() * sizeof(int64_t)
+         + name_off.capacity() * sizeof(uint32_t) + names.capacity() + data.capacity() * sizeof(const FileData*);
+}
+
+//create a method that writes the columns after a snapshot header, through a temporary file that is synced and renamed into place
+bool InodeTable::save(const string& filename, FileStore& files, const vector<SnapshotBinItem>& extra_items, uint64_t bin_next_id, uint64_t journal_sequence) const {
+    uint64_t n = parent.size();
+    vector<uint64_t> data_off(1, 0);//what each file holds of its size, the rest reads as zeros
+    for (uint64_t i = 0; i < n; ++i) {
+        data_off.push_back(data_off.back() + (data[i] != nullptr ? min(data[i]->stored, size[i]) : 0));
+    }
+    vector<uint32_t> path_off(1, 0);//the paths of the extra roots, in one pool like the names
+    string paths;
+    vector<uint64_t> ids(extra.size(), 0);
+    vector<int64_t> times(extra.size(), 0);
+    for (size_t k = 0; k < extra.size(); ++k) {
+        if (k < extra_items.size()) {
+            paths += extra_items[k].path;
+            ids[k] = extra_items[k].id;
+            times[k] = extra_items[k].deleted;
+        }
+        path_off.push_back(paths.size());
+    }
+
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header.version = SNAPSHOT_VERSION;
+    header.header_bytes = sizeof(SnapshotHeader);
+    header.count = n;
+    header.names_bytes = names.size();
+    header.bin_count = extra.size();
+    header.bin_paths_bytes = paths.size();
+    header.bin_next_id = bin_next_id;
+    header.journal_sequence = journal_sequence;
+    header.data_bytes = data_off.back();
+    uint64_t offset = (sizeof(SnapshotHeader) + 7) / 8 * 8;
+    for (int s = 0; s < SECTIONS; ++s) {
+        header.offset[s] = offset;
+        offset += (sectionElements(header, s) * SECTION_WIDTHS[s] + 7) / 8 * 8;
+    }
+
+    //in preorder the first child directly follows its parent and the next sibling starts where the subtree ends
+    vector<uint32_t> first_child(n), next_sibling(n);
+    for (uint64_t i = 0; i < n; ++i) {
+        first_child[i] = (i + 1 < end[i]) ? i + 1 : NONE;
+        next_sibling[i] = (parent[i] != NONE && end[i] < end[parent[i]]) ? end[i] : NONE;
+    }
+
+    BlockWriter out;
+    if (!out.open(filename)) {
+        return false;
+    }
+    const void* columns[SECTIONS] = {parent.data(), first_child.data(), next_sibling.data(), end.data(), type.data(),
+                                     size.data(), cr_time.data(), name_off.data(), names.data(),
+                                     extra.data(), path_off.data(), paths.data(), ids.data(), times.data(), data_off.data(), nullptr};
+    out.write(&header, sizeof(header));
+    out.zeros(header.offset[0] - sizeof(header));
+    for (int s = 0; s < SECTIONS; ++s) {
+        uint64_t bytes = sectionElements(header, s) * SECTION_WIDTHS[s];
+        if (s != SEC_DATA) {
+            out.write(columns[s], bytes);
+        } else {//the contents are written from their blocks, file by file
+            for (uint64_t i = 0; i < n; ++i) {
+                files.read(data[i], data_off[i + 1] - data_off[i], 0, data_off[i + 1] - data_off[i], [&out](const char* from, uint64_t piece) { out.write(from, piece); });
+            }
+        }
+        out.zeros((bytes + 7) / 8 * 8 - bytes);
+    }
+    return out.commit();
+}
+
+#endif
@@ -0,0 +1,448 @@
+//============================================================================
+// Name         : journal.hpp
+// Author       : Aysa Binte masud
+// Version      : 01
+// Date Created : 17 October 2026
+// Date Modified: 17 October 2026
+// Description  : Append-only write-ahead journal of VFS operations
+//============================================================================
+//
+// Every change to the tree is appended as one record:
+//   length(u32) type(u8) sequence(u64) size(u64) time(i64)
+//   path length(u32) name length(u32) target length(u32) path name target
+//   checksum(u64)
+// Records are collected in memory and written with a single write() per
+// commit (group commit). When they are also fsync'ed depends on the sync
+// policy. Under the batch policy a commit syncs once 64 commits are not
+// synced yet, and a flusher thread syncs the others when the oldest of them
+// is 20 ms old, so a command on an idle shell is not left unsynced until the
+// next one. The flusher and the writers share the journal's mutex. A sync
+// with nothing written since the last one does not touch the disk. Replay
+// stops at the first torn or corrupt record and cuts the file there, so a
+// crash in the middle of a write loses only that record.
+// A checkpoint written in the background holds the records up to where the
+// journal ended when it started; afterwards dropBefore copies the records
+// appended since into a new file that is renamed over the journal.
+//
+#ifndef JOURNAL_H
+#define JOURNAL_H
+#include<cerrno>
+#include<cstdint>
+#include<cstring>
+#include<cstdio>
+#include<string>
+#include<vector>
+#include<chrono>
+#include<algorithm>
+#include<mutex>
+#include<thread>
+#include<condition_variable>
+#include<fcntl.h>
+#include<unistd.h>
+#include<sys/stat.h>
+#include "hash.hpp"
+using namespace std;
+
+enum JournalOp {J_MKDIR=1, J_TOUCH, J_RM, J_MV, J_RECOVER, J_EMPTYBIN, J_PURGE, J_CP, J_SNAPSHOT, J_DROP, J_WRITE, J_APPEND, J_TRUNCATE};
+enum SyncPolicy {SYNC_ALWAYS, SYNC_BATCH, SYNC_NONE};
+
+struct JournalRecord
+{
+    uint8_t type;           //a JournalOp
+    uint64_t sequence;      //increasing number of the record
+    uint64_t size;          //size of a new file, or the size truncate sets
+    int64_t time;           //creation time of a new Inode
+    string path;            //folder the operation was run in
+    string name;            //name of the Inode it applies to
+    string target;          //destination folder of mv, source path of cp, the bytes of write and append
+};
+
+class Journal
+{
+    private:
+        static const size_t HEADER_BYTES = 4 + 1 + 8 + 8 + 8 + 4 + 4 + 4;
+        static const int BATCH_RECORDS = 64;        //SYNC_BATCH syncs after this many unsynced records
+        static const int BATCH_MILLISECONDS = 20;   //or when the oldest unsynced record is this old
+
+        int fd;                     //journal file, -1 if closed
+        string filename;            //where it is, for dropBefore
+        string buffer;              //records appended since the last commit
+        SyncPolicy policy;          //when commits are fsync'ed
+        uint64_t next_sequence;     //sequence number of the next record
+        uint64_t file_bytes;        //current length of the file
+        int unsynced;               //records written but not fsync'ed
+        chrono::steady_clock::time_point first_unsynced;
+        uint64_t records, commits, syncs;   //statistics
+        mutable recursive_mutex lock;   //guards the file and the buffer against the flusher
+        condition_variable_any flush_due;   //wakes the flusher when a commit is left unsynced
+        thread flusher;             //syncs the batch policy's commits once the oldest is old enough
+        bool stopping;              //tells the flusher to end
+
+        static void putU32(string& out, uint32_t v);
+        static void putU64(string& out, uint64_t v);
+        static uint32_t getU32(const char* p);
+        static uint64_t getU64(const char* p);
+        bool writeAll(const char* data, size_t length);
+        void flush();               //body of the flusher thread
+
+        Journal(const Journal&);
+        Journal& operator=(const Journal&);
+    public:
+        Journal();
+        ~Journal();
+        bool open(const string& filename, uint64_t first_sequence);  //open for appending
+        void close();
+        bool isOpen() const;
+        void append(uint8_t type, const string& path, const string& name, const string& target, uint64_t size, int64_t time);
+        void commit();                          //write the appended records, fsync'ing them as the policy says
+        void sync();                            //write and fsync everything now
+        bool reset();                           //drop all records after a checkpoint
+        bool dropBefore(uint64_t bytes);        //drop the first bytes of the file, which a checkpoint holds
+        void setPolicy(SyncPolicy p);
+        SyncPolicy getPolicy() const;
+        uint64_t nextSequence() const;
+        uint64_t fileBytes() const;
+        uint64_t recordCount() const;
+        uint64_t commitCount() const;
+        uint64_t syncCount() const;
+
+        //read every complete record of a journal file; returns false if the file cannot be read
+        static bool replay(const string& filename, vector<JournalRecord>& out);
+};
+//================================================
+
+const size_t Journal::HEADER_BYTES;
+const int Journal::BATCH_RECORDS;
+const int Journal::BATCH_MILLISECONDS;
+
+Journal::Journal() : fd(-1), policy(SYNC_BATCH), next_sequence(1), file_bytes(0), unsynced(0), records(0), commits(0), syncs(0), stopping(false) {
+}
+
+Journal::~Journal() {
+    close();
+}
+
+void Journal::putU32(string& out, uint32_t v) {
+    out.append(reinterpret_cast<const char*>(&v), 4);
+}
+
+void Journal::putU64(string& out, uint64_t v) {
+    out.append(reinterpret_cast<const char*>(&v), 8);
+}
+
+uint32_t Journal::getU32(const char* p) {
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return v;
+}
+
+uint64_t Journal::getU64(const char* p) {
+    uint64_t v;
+    memcpy(&v, p, 8);
+    return v;
+}
+
+bool Journal::writeAll(const char* data, size_t length) {
+    while (length > 0) {
+        ssize_t n = ::write(fd, data, length);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += n;
+        length -= n;
+        file_bytes += n;
+    }
+    return true;
+}
+
+bool Journal::open(const string& filename, uint64_t first_sequence) {
+    close();
+    lock_guard<recursive_mutex> guard(lock);
+    fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    this->filename = filename;
+    struct stat st;
+    file_bytes = (fstat(fd, &st) == 0) ? st.st_size : 0;
+    next_sequence = first_sequence;
+    unsynced = 0;
+    stopping = false;
+    flusher = thread(&Journal::flush, this);
+    return true;
+}
+
+//create a method that stops the flusher, then flushes what is left and closes the file
+void Journal::close() {
+    if (flusher.joinable()) {
+        {
+            lock_guard<recursive_mutex> guard(lock);
+            stopping = true;
+        }
+        flush_due.notify_one();
+        flusher.join();
+    }
+    lock_guard<recursive_mutex> guard(lock);
+    if (fd >= 0) {
+        sync();
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+//create a method that waits for the oldest unsynced commit to be BATCH_MILLISECONDS old and syncs what was written by then
+void Journal::flush() {
+    unique_lock<recursive_mutex> guard(lock);
+    while (!stopping) {
+        if (fd < 0 || unsynced == 0 || policy != SYNC_BATCH) {
+            flush_due.wait(guard);
+            continue;
+        }
+        chrono::steady_clock::time_point due = first_unsynced + chrono::milliseconds(BATCH_MILLISECONDS);
+        if (chrono::steady_clock::now() < due) {
+            flush_due.wait_until(guard, due);
+            continue;
+        }
+        //only what commit wrote; records appended for a later commit stay in the buffer
+        fdatasync(fd);
+        syncs++;
+        unsynced = 0;
+    }
+}
+
+bool Journal::isOpen() const {
+    return fd >= 0;
+}
+
+//create a method that encodes a record into the commit buffer
+void Journal::append(uint8_t type, const string& path, const string& name, const string& target, uint64_t size, int64_t time) {
+    lock_guard<recursive_mutex> guard(lock);
+    if (fd < 0) {
+        return;
+    }
+    size_t start = buffer.size();
+    uint32_t length = HEADER_BYTES + path.size() + name.size() + target.size() + 8;
+    putU32(buffer, length);
+    buffer += static_cast<char>(type);
+    putU64(buffer, next_sequence++);
+    putU64(buffer, size);
+    putU64(buffer, static_cast<uint64_t>(time));
+    putU32(buffer, path.size());
+    putU32(buffer, name.size());
+    putU32(buffer, target.size());
+    buffer += path;
+    buffer += name;
+    buffer += target;
+    putU64(buffer, hashBytes(buffer.data() + start, buffer.size() - start));
+    records++;
+}
+
+//create a method that writes the buffered records with one system call (the group commit)
+void Journal::commit() {
+    lock_guard<recursive_mutex> guard(lock);
+    if (fd < 0 || buffer.empty()) {
+        return;
+    }
+    if (!writeAll(buffer.data(), buffer.size())) {
+        throw runtime_error("could not write the journal");
+    }
+    buffer.clear();
+    commits++;
+    if (unsynced == 0) {
+        first_unsynced = chrono::steady_clock::now();
+    }
+    unsynced++;
+
+    if (policy == SYNC_ALWAYS) {
+        sync();
+    } else if (policy == SYNC_BATCH && (unsynced >= BATCH_RECORDS
+               || chrono::steady_clock::now() - first_unsynced >= chrono::milliseconds(BATCH_MILLISECONDS))) {
+        sync();
+    } else if (policy == SYNC_BATCH && unsynced == 1) {
+        flush_due.notify_one();//the flusher syncs it if no commit does within BATCH_MILLISECONDS
+    }
+}
+
+void Journal::sync() {
+    lock_guard<recursive_mutex> guard(lock);
+    if (fd < 0) {
+        return;
+    }
+    if (!buffer.empty()) {
+        if (!writeAll(buffer.data(), buffer.size())) {
+            throw runtime_error("could not write the journal");
+        }
+        buffer.clear();
+        unsynced++;//records appended without a commit are synced with the rest
+    }
+    if (unsynced > 0) {//otherwise everything written is on disk already
+        fdatasync(fd);
+        syncs++;
+    }
+    unsynced = 0;
+}
+
+//create a method that empties the journal once a checkpoint holds everything in it
+bool Journal::reset() {
+    lock_guard<recursive_mutex> guard(lock);
+    if (fd < 0) {
+        return false;
+    }
+    buffer.clear();
+    if (ftruncate(fd, 0) != 0) {
+        return false;
+    }
+    fdatasync(fd);
+    file_bytes = 0;
+    unsynced = 0;
+    return true;
+}
+
+//create a method that keeps only the records after the first bytes, through a temporary file renamed over the journal so a crash leaves one whole file
+bool Journal::dropBefore(uint64_t bytes) {
+    lock_guard<recursive_mutex> guard(lock);
+    if (fd < 0) {
+        return false;
+    }
+    sync();
+    if (bytes >= file_bytes) {
+        return reset();
+    }
+    if (bytes == 0) {
+        return true;
+    }
+    string temp = filename + ".tmp";
+    int in = ::open(filename.c_str(), O_RDONLY);
+    int out = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    bool ok = in >= 0 && out >= 0;
+    vector<char> chunk(1 << 20);
+    for (uint64_t offset = bytes; ok && offset < file_bytes; ) {
+        ssize_t n = pread(in, chunk.data(), min<uint64_t>(chunk.size(), file_bytes - offset), offset);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        ok = n > 0;
+        for (ssize_t done = 0; ok && done < n; ) {
+            ssize_t w = ::write(out, chunk.data() + done, n - done);
+            if (w < 0 && errno == EINTR) {
+                continue;
+            }
+            ok = w > 0;
+            done += ok ? w : 0;
+        }
+        offset += ok ? n : 0;
+    }
+    ok = ok && fdatasync(out) == 0;
+    if (in >= 0) {
+        ::close(in);
+    }
+    if (out >= 0) {
+        ::close(out);
+    }
+    if (!ok || rename(temp.c_str(), filename.c_str()) != 0) {
+        remove(temp.c_str());
+        return false;
+    }
+
+    //the appends go on in the new file
+    ::close(fd);
+    fd = ::open(filename.c_str(), O_WRONLY | O_APPEND);
+    if (fd < 0) {
+        return false;
+    }
+    file_bytes -= bytes;
+    unsynced = 0;
+    return true;
+}
+
+void Journal::setPolicy(SyncPolicy p) {
+    lock_guard<recursive_mutex> guard(lock);
+    policy = p;
+    sync();
+    flush_due.notify_one();
+}
+
+SyncPolicy Journal::getPolicy() const {
+    return policy;
+}
+
+uint64_t Journal::nextSequence() const {
+    return next_sequence;
+}
+
+uint64_t Journal::fileBytes() const {
+    return file_bytes + buffer.size();
+}
+
+uint64_t Journal::recordCount() const {
+    return records;
+}
+
+uint64_t Journal::commitCount() const {
+    return commits;
+}
+
+uint64_t Journal::syncCount() const {
+    lock_guard<recursive_mutex> guard(lock);//the flusher counts its syncs too
+    return syncs;
+}
+
+//create a method that decodes the file record by record and cuts off a torn tail
+bool Journal::replay(const string& filename, vector<JournalRecord>& out) {
+    int in = ::open(filename.c_str(), O_RDWR);
+    if (in < 0) {
+        return errno == ENOENT;//no journal is the same as an empty one
+    }
+    struct stat st;
+    if (fstat(in, &st) != 0) {
+        ::close(in);
+        return false;
+    }
+    string data(st.st_size, '\0');
+    size_t got = 0;
+    while (got < data.size()) {
+        ssize_t n = ::read(in, &data[got], data.size() - got);
+        if (n <= 0) {
+            break;
+        }
+        got += n;
+    }
+    data.resize(got);
+
+    size_t pos = 0;
+    while (pos + HEADER_BYTES + 8 <= data.size()) {
+        const char* p = data.data() + pos;
+        uint32_t length = getU32(p);
+        if (length < HEADER_BYTES + 8 || length > data.size() - pos) {
+            break;
+        }
+        uint32_t path_length = getU32(p + 29), name_length = getU32(p + 33), target_length = getU32(p + 37);
+        if ((uint64_t)HEADER_BYTES + path_length + name_length + target_length + 8 != length
+            || getU64(p + length - 8) != hashBytes(p, length - 8)) {
+            break;
+        }
+        JournalRecord r;
+        r.type = static_cast<uint8_t>(p[4]);
+        r.sequence = getU64(p + 5);
+        r.size = getU64(p + 13);
+        r.time = static_cast<int64_t>(getU64(p + 21));
+        r.path.assign(p + HEADER_BYTES, path_length);
+        r.name.assign(p + HEADER_BYTES + path_length, name_length);
+        r.target.assign(p + HEADER_BYTES + path_length + name_length, target_length);
+        out.push_back(r);
+        pos += length;
+    }
+
+    if (pos < data.size()) {//a partial record from a crash
+        if (ftruncate(in, pos) == 0) {
+            fdatasync(in);
+        }
+    }
+    ::close(in);
+    return true;
+}
+
+#endif
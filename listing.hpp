@@ -0,0 +1,168 @@
+//============================================================================
+// Name         : listing.hpp
+// Author       : Aysa Binte masud
+// Version      : 01
+// Date Created : 17 October 2026
+// Date Modified: 17 October 2026
+// Description  : Options and buffered output of ls in C++
+//============================================================================
+//
+// ls [--sort name|size|time] [--limit N] [--after name] [prefix*] lists a
+// page of a folder: the entries after the named one in the chosen order,
+// at most N of them, whose names start with the prefix. Sizes and times
+// are listed largest and newest first, ties by name. The lines are put
+// together in a string and written to the stream in blocks of 64 KB, and
+// a creation time is formatted once for all the entries that share it.
+//
+#ifndef LISTING_H
+#define LISTING_H
+#include<cstdint>
+#include<cstdlib>
+#include<string>
+#include<sstream>
+#include<ostream>
+#include "inode.hpp"
+using namespace std;
+
+enum ListSort {SORT_NONE=0, SORT_NAME, SORT_SIZE, SORT_TIME};
+
+struct ListOptions
+{
+    ListSort sort;                  //SORT_NONE keeps the order the entries were added in
+    size_t limit;                   //0 for no limit
+    string after;                   //list only what comes after this entry, empty for the first page
+    string prefix;                  //list only the names that start with this
+
+    ListOptions() : sort(SORT_NONE), limit(0) { }
+    bool parse(const string& options, string& error);  //false, with the reason, for options ls does not take
+    bool before(const Inode* a, const Inode* b) const;  //true if a is listed before b
+    bool matches(const Inode* node) const;              //true if the name has the prefix
+};
+
+//gathers the lines of a listing and writes them to the stream in blocks
+class ListWriter
+{
+    private:
+        static const size_t BLOCK = 64 << 10;
+        ostream& out;
+        string buffer;
+        int64_t time_epoch;             //the creation time formatted last
+        string time_text;
+
+        ListWriter(const ListWriter&);
+        ListWriter& operator=(const ListWriter&);
+    public:
+        ListWriter(ostream& out);
+        ~ListWriter();
+        void entry(bool type, const char* name, size_t length, int64_t cr_time, uint64_t size);    //one line the way ls prints it
+        void entry(const Inode* node);
+        void line(const string& text);
+        void flush();                   //write what has gathered
+};
+//================================================
+
+//create a method that reads the options of ls, a word at a time
+bool ListOptions::parse(const string& options, string& error) {
+    istringstream words(options);
+    string word;
+    while (words >> word) {
+        if (word == "--sort") {
+            string key;
+            words >> key;
+            if (key == "name") {
+                sort = SORT_NAME;
+            } else if (key == "size") {
+                sort = SORT_SIZE;
+            } else if (key == "time") {
+                sort = SORT_TIME;
+            } else {
+                error = "Unknown sort order '" + key + "', use name, size or time.";
+                return false;
+            }
+        } else if (word == "--limit") {
+            string count;
+            words >> count;
+            char* end = nullptr;
+            unsigned long long n = strtoull(count.c_str(), &end, 10);
+            if (count.empty() || *end != '\0' || n == 0) {
+                error = "The limit must be a positive number.";
+                return false;
+            }
+            limit = static_cast<size_t>(n);
+        } else if (word == "--after") {
+            if (!(words >> after)) {
+                error = "--after needs the name of an entry.";
+                return false;
+            }
+        } else if (word.size() > 0 && word[word.size() - 1] == '*' && word.find_first_of("*?[") == word.size() - 1) {
+            prefix = word.substr(0, word.size() - 1);
+        } else {
+            error = "Usage: ls [--sort name|size|time] [--limit N] [--after name] [prefix*]";
+            return false;
+        }
+    }
+    if (sort == SORT_NONE) {//a page or a prefix is a range of names
+        sort = SORT_NAME;
+    }
+    return true;
+}
+
+bool ListOptions::before(const Inode* a, const Inode* b) const {
+    if (sort == SORT_SIZE && a->getSize() != b->getSize()) {
+        return a->getSize() > b->getSize();
+    }
+    if (sort == SORT_TIME && a->getCreationEpoch() != b->getCreationEpoch()) {
+        return a->getCreationEpoch() > b->getCreationEpoch();
+    }
+    return a->getName() < b->getName();
+}
+
+bool ListOptions::matches(const Inode* node) const {
+    return node->getName().compare(0, prefix.size(), prefix) == 0;
+}
+
+const size_t ListWriter::BLOCK;
+
+ListWriter::ListWriter(ostream& out) : out(out), time_epoch(0), time_text(formatTime(0)) {
+    buffer.reserve(BLOCK + 256);
+}
+
+ListWriter::~ListWriter() {
+    flush();
+}
+
+void ListWriter::entry(bool type, const char* name, size_t length, int64_t cr_time, uint64_t size) {
+    if (cr_time != time_epoch) {//entries created in the same second share the formatted time
+        time_epoch = cr_time;
+        time_text = formatTime(cr_time);
+    }
+    buffer += type == Folder ? "dir " : "file ";
+    buffer.append(name, length);
+    buffer += ' ';
+    buffer += time_text;
+    buffer += ' ';
+    buffer += to_string(size);
+    buffer += " bytes\n";
+    if (buffer.size() >= BLOCK) {
+        flush();
+    }
+}
+
+void ListWriter::entry(const Inode* node) {
+    entry(node->getType(), node->getName().data(), node->getName().size(), node->getCreationEpoch(), node->getSize());
+}
+
+void ListWriter::line(const string& text) {
+    buffer += text;
+    buffer += '\n';
+    if (buffer.size() >= BLOCK) {
+        flush();
+    }
+}
+
+void ListWriter::flush() {
+    out.write(buffer.data(), buffer.size());
+    buffer.clear();
+}
+
+#endif
@@ -0,0 +1,203 @@
+//============================================================================
+// Name         : loader.hpp
+// Author       : Aysa Binte masud
+// Version      : 01
+// Date Created : 17 October 2026
+// Date Modified: 17 October 2026
+// Description  : Buffered line reader and field parsers for vfs.dat
+//============================================================================
+//
+// vfs.dat holds one entry per line: path,size,date where the date is
+// dd-mm-yy (or dd-mm-yyyy), optionally followed by " hh:mm:ss". The reader
+// pulls the file through one large buffer with read(2) and hands out each
+// line as a pointer and a length into that buffer, so nothing is copied or
+// allocated per line.
+//
+#ifndef LOADER_H
+#define LOADER_H
+#include<cerrno>
+#include<cstdint>
+#include<cstring>
+#include<ctime>
+#include<string>
+#include<fcntl.h>
+#include<unistd.h>
+using namespace std;
+
+class LineReader
+{
+    private:
+        int fd;                 //file being read, -1 if none
+        char *buffer;           //read buffer
+        size_t capacity;        //size of the buffer
+        size_t begin;           //start of the unread data in the buffer
+        size_t end;             //end of the valid data in the buffer
+        bool eof;               //true once read() returned 0
+        uint64_t bytes;         //bytes read from the file so far
+
+        bool fill();            //move the unread data to the front and read more
+
+        LineReader(const LineReader&);
+        LineReader& operator=(const LineReader&);
+    public:
+        LineReader(size_t buffer_size = 4 << 20);
+        ~LineReader();
+        bool open(const string& filename);
+        void close();
+        bool next(const char*& line, size_t& length);   //the next line without its line break, false at the end
+        uint64_t bytesRead() const;
+};
+//================================================
+
+LineReader::LineReader(size_t buffer_size) : fd(-1), capacity(buffer_size), begin(0), end(0), eof(false), bytes(0) {
+    buffer = new char[capacity];
+}
+
+LineReader::~LineReader() {
+    close();
+    delete[] buffer;
+}
+
+bool LineReader::open(const string& filename) {
+    close();
+    fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);//let the kernel read ahead aggressively
+#endif
+    begin = end = 0;
+    eof = false;
+    bytes = 0;
+    return true;
+}
+
+void LineReader::close() {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+//create a method that keeps the partial line at the front of the buffer and appends the next chunk of the file
+bool LineReader::fill() {
+    if (eof) {
+        return false;
+    }
+    if (begin > 0) {
+        memmove(buffer, buffer + begin, end - begin);
+        end -= begin;
+        begin = 0;
+    }
+    if (end == capacity) {//a single line longer than the buffer
+        char* bigger = new char[capacity * 2];
+        memcpy(bigger, buffer, end);
+        delete[] buffer;
+        buffer = bigger;
+        capacity *= 2;
+    }
+
+    ssize_t n;
+    do {
+        n = ::read(fd, buffer + end, capacity - end);
+    } while (n < 0 && errno == EINTR);
+    if (n <= 0) {
+        eof = true;
+        return false;
+    }
+    end += n;
+    bytes += n;
+    return true;
+}
+
+bool LineReader::next(const char*& line, size_t& length) {
+    size_t scanned = begin;//where to continue looking for the line break after a refill
+    while (true) {
+        const char* nl = static_cast<const char*>(memchr(buffer + scanned, '\n', end - scanned));
+        if (nl != nullptr) {
+            line = buffer + begin;
+            length = nl - line;
+            begin = nl - buffer + 1;
+            break;
+        }
+        scanned = end - begin;//offset of the unscanned data once fill() moved it to the front
+        if (!fill()) {
+            if (begin == end) {
+                return false;
+            }
+            line = buffer + begin;//the last line has no line break
+            length = end - begin;
+            begin = end;
+            break;
+        }
+    }
+    if (length > 0 && line[length - 1] == '\r') {
+        length--;
+    }
+    return true;
+}
+
+uint64_t LineReader::bytesRead() const {
+    return bytes;
+}
+
+//parse the decimal digits of a field, false if there are none or other characters
+inline bool parseUnsigned(const char* s, size_t length, uint64_t& value) {
+    if (length == 0) {
+        return false;
+    }
+    value = 0;
+    for (size_t i = 0; i < length; ++i) {
+        unsigned digit = static_cast<unsigned char>(s[i]) - '0';
+        if (digit > 9) {
+            return false;
+        }
+        value = value * 10 + digit;
+    }
+    return true;
+}
+
+//parse dd-mm-yy or dd-mm-yyyy with an optional " hh:mm:ss" into local time
+inline bool parseDate(const char* s, size_t length, int64_t& epoch) {
+    uint64_t day, month, year, hour = 0, minute = 0, second = 0;
+    const char* dash1 = static_cast<const char*>(memchr(s, '-', length));
+    if (dash1 == nullptr) {
+        return false;
+    }
+    const char* dash2 = static_cast<const char*>(memchr(dash1 + 1, '-', s + length - dash1 - 1));
+    if (dash2 == nullptr) {
+        return false;
+    }
+    const char* space = static_cast<const char*>(memchr(dash2 + 1, ' ', s + length - dash2 - 1));
+    const char* date_end = space != nullptr ? space : s + length;
+    if (!parseUnsigned(s, dash1 - s, day) || !parseUnsigned(dash1 + 1, dash2 - dash1 - 1, month)
+        || !parseUnsigned(dash2 + 1, date_end - dash2 - 1, year)) {
+        return false;
+    }
+    if (date_end - dash2 - 1 <= 2) {
+        year += 2000;
+    }
+    if (space != nullptr) {//hh:mm:ss
+        const char* t = space + 1;
+        size_t t_length = s + length - t;
+        if (t_length != 8 || t[2] != ':' || t[5] != ':' || !parseUnsigned(t, 2, hour)
+            || !parseUnsigned(t + 3, 2, minute) || !parseUnsigned(t + 6, 2, second)) {
+            return false;
+        }
+    }
+
+    tm fields;
+    memset(&fields, 0, sizeof(fields));
+    fields.tm_mday = day;
+    fields.tm_mon = month - 1;
+    fields.tm_year = year - 1900;
+    fields.tm_hour = hour;
+    fields.tm_min = minute;
+    fields.tm_sec = second;
+    fields.tm_isdst = -1;
+    epoch = static_cast<int64_t>(mktime(&fields));
+    return true;
+}
+
+#endif
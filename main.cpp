@@ -1,56 +1,51 @@
 #include<iostream>
-#include<sstream>
+#include<string>
 #include<stdlib.h>
+#include<unistd.h>
 #include "vfs.hpp"
+#include "shell.hpp"
 using namespace std;
 
 
-int main()
+int main(int argc, char* argv[])
 {
-	VFS vfs;
-	
-
-	while(true)
+	//output --batch script runs a script; so does a script piped into the shell
+	string script;
+	for(int i=1; i<argc; i++)
 	{
-		string user_input;
-		string command;
-		string parameter1;
-		string parameter2;
-		cout<<">";
-		getline(cin,user_input);
+		if(string(argv[i])=="--batch" && i+1<argc)	script=argv[++i];
+	}
+	bool batch = !script.empty() || !isatty(STDIN_FILENO);
 
-		// parse userinput into command and parameter(s)
-		stringstream sstr(user_input);
-		getline(sstr,command,' ');
-		getline(sstr,parameter1,' ');
-		getline(sstr,parameter2);
+	//in batch mode everything printed is gathered and written in large blocks
+	BatchOutput batch_output;
+	streambuf* console = cout.rdbuf();
+	if(batch)	cout.rdbuf(&batch_output);
 
-		try
-		{
-			//Required commands
-			if(command=="help")		vfs.help();
-			else if(command=="pwd")			cout<<vfs.pwd()<<endl;
-			else if(command=="ls") 			vfs.ls();
-			else if(command=="mkdir")		vfs.mkdir(parameter1);
-			else if(command=="touch")		vfs.touch(parameter1,stoi(parameter2));
-			else if(command=="cd")			vfs.cd(parameter1);
-			else if(command=="rm")			vfs.rm(parameter1);
-			else if(command=="size")		vfs.size(parameter1);
-			else if(command=="showbin")		vfs.showbin();
-			else if(command=="emptybin")	vfs.emptybin();
-			else if(command=="exit")		{vfs.exit(); return(EXIT_SUCCESS);}
+	VFS vfs;
+	//start from the saved file system if there is one, preferring the binary snapshot
+	if(!(ifstream("vfs.snap").good() && vfs.mount("vfs.snap")) && ifstream("vfs.dat").good())	vfs.load("vfs.dat");
+	//then redo the changes made since the last checkpoint
+	vfs.openJournal("vfs.journal", "vfs.snap");
 
-			//optional commands
-			else if(command=="find")		vfs.find(parameter1);
-			else if(command=="mv")			vfs.mv(parameter1, parameter2);
-			else if(command=="recover")		vfs.recover();
-			else if(command=="clear")		system("clear");
-			else 							cout<<command<<": command not found"<<endl;
-		}
-		catch(exception &e)
+	CommandTable commands;
+	if(batch)
+	{
+		runBatch(vfs, commands, script.empty() ? "/dev/stdin" : script, batch_output);
+	}
+	else
+	{
+		string user_input;
+		while(true)
 		{
-			cout<<"Exception: "<<e.what()<<endl;
+			cout<<">";
+			if(!getline(cin,user_input) || !commands.execute(vfs, user_input.data(), user_input.size()))	break;
 		}
-
 	}
-}
\ No newline at end of file
+
+	//exit does not return, so the gathered output goes first
+	batch_output.writeOut();
+	cout.rdbuf(console);
+	vfs.exit();
+	return(EXIT_SUCCESS);
+}
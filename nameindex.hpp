@@ -0,0 +1,113 @@
+//============================================================================
+// Name         : nameindex.hpp
+// Author       : Aysa Binte masud
+// Version      : 01
+// Date Created : 17 October 2026
+// Date Modified: 17 October 2026
+// Description  : Global name to Inodes index used by find in C++
+//============================================================================
+//
+// One bucket per distinct name, found through a HashIndex, holds every Inode
+// with that name. Each Inode remembers its slot in the bucket, so adding and
+// removing one is O(1) (a removal moves the last Inode of the bucket into
+// the freed slot). The index holds Inodes, not paths: moving an Inode does
+// not touch it, and the path of a hit is built from its parent chain.
+//
+#ifndef NAMEINDEX_H
+#define NAMEINDEX_H
+#include<cstdint>
+#include<string>
+#include "inode.hpp"
+#include "vector.hpp"
+#include "hashindex.hpp"
+#include "slabpool.hpp"
+using namespace std;
+
+class NameIndex
+{
+    private:
+        struct Bucket
+        {
+            string name;                //the name shared by the Inodes
+            uint64_t name_hash;
+            Vector<Inode*> nodes;       //the Inodes, in no particular order
+
+            Bucket(const string& name, uint64_t hash) : name(name), name_hash(hash) { }
+            const string& getName() const { return name; }
+            uint64_t getNameHash() const { return name_hash; }
+        };
+
+        HashIndex<Bucket> buckets;      //bucket of each name
+        SlabPool<Bucket> pool;          //where the buckets live
+        size_t entries;                 //number of indexed Inodes
+
+        NameIndex(const NameIndex&);
+        NameIndex& operator=(const NameIndex&);
+    public:
+        NameIndex();
+        void insert(Inode* node);                       //index an Inode under its name
+        void erase(Inode* node);                        //forget an Inode, which must be indexed
+        Vector<Inode*>* find(const string& name);       //the Inodes called name, nullptr if there are none
+        void clear();
+        size_t size() const;                            //number of indexed Inodes
+        size_t nameCount() const;                       //number of distinct names
+        size_t memoryBytes() const;
+};
+//================================================
+
+NameIndex::NameIndex() : entries(0) {
+}
+
+//create a method that appends the Inode to the bucket of its name, creating the bucket for a new name
+void NameIndex::insert(Inode* node) {
+    Bucket* bucket = buckets.find(node->getName(), node->getNameHash());
+    if (bucket == nullptr) {
+        bucket = pool.create(node->getName(), node->getNameHash());
+        buckets.insert(bucket);
+    }
+    node->name_slot = bucket->nodes.size();
+    bucket->nodes.push_back(node);
+    entries++;
+}
+
+//create a method that fills the Inode's slot with the last Inode of the bucket, dropping the bucket once it is empty
+void NameIndex::erase(Inode* node) {
+    Bucket* bucket = buckets.find(node->getName(), node->getNameHash());
+    if (bucket == nullptr || node->name_slot >= (uint32_t)bucket->nodes.size() || bucket->nodes[node->name_slot] != node) {
+        return;//not indexed
+    }
+    Inode* moved = bucket->nodes[bucket->nodes.size() - 1];
+    moved->name_slot = node->name_slot;
+    bucket->nodes.swap_erase(node->name_slot);
+    entries--;
+
+    if (bucket->nodes.empty()) {
+        buckets.erase(bucket);
+        pool.destroy(bucket);
+    }
+}
+
+Vector<Inode*>* NameIndex::find(const string& name) {
+    Bucket* bucket = buckets.find(name, hashName(name));
+    return bucket != nullptr ? &bucket->nodes : nullptr;
+}
+
+void NameIndex::clear() {
+    buckets.clear();
+    pool.reset();
+    entries = 0;
+}
+
+size_t NameIndex::size() const {
+    return entries;
+}
+
+size_t NameIndex::nameCount() const {
+    return buckets.size();
+}
+
+size_t NameIndex::memoryBytes() const {
+    return buckets.memoryBytes() + pool.bytesReserved() + entries * sizeof(Inode*);
+}
+
+#endif
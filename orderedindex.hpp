@@ -0,0 +1,410 @@
+//============================================================================
+// Name         : orderedindex.hpp
+// Author       : Aysa Binte masud
+// Version      : 01
+// Date Created : 17 October 2026
+// Date Modified: 17 October 2026
+// Description  : B+ tree of items ordered by name in C++
+//============================================================================
+//
+// The items are kept in leaves of up to 64 pointers, sorted by name and
+// linked from left to right, under branches that hold the first name of
+// each child. Finding the first name not less than a key is a descent of
+// a few binary searches, and a range is then read leaf by leaf, so a
+// prefix or a page of k names costs O(log n + k). A leaf or a branch that
+// falls below a quarter full after an erase takes children from a
+// neighbour, or is merged into it when both fit in one, and a root left
+// with one child is replaced by it, so after any number of erases every
+// leaf but a lone root holds at least 16 items and the height stays
+// logarithmic. The separators copied into branches still bound the names
+// below them after their item is erased. T must provide getName(); names
+// are unique within an index.
+//
+#ifndef ORDEREDINDEX_H
+#define ORDEREDINDEX_H
+#include<cstdint>
+#include<cstring>
+#include<string>
+#include<vector>
+#include<algorithm>
+using namespace std;
+
+template <typename T>
+class OrderedIndex
+{
+    private:
+        static const int FANOUT = 64;   //items per leaf, children per branch
+        static const int MINIMUM = FANOUT / 4;  //fewer items or children than this is an underflow
+
+        struct Leaf
+        {
+            int count;
+            Leaf* next;                 //the leaf to the right
+            T* items[FANOUT];           //sorted by name
+        };
+        struct Branch
+        {
+            int count;
+            string first[FANOUT];       //a lower bound of the names in each child, first[0] is not used
+            void* child[FANOUT];        //Branches above height 1, Leaves at height 1
+        };
+
+        void* root;                     //a Leaf while height is 0
+        int height;                     //levels of branches above the leaves
+        size_t used;                    //number of items
+        Leaf* head;                     //leftmost leaf
+
+        static int childFor(const Branch* branch, const string& name);     //the child whose range holds name
+        static int leafPosition(const Leaf* leaf, const string& name);     //first position not less than name
+        void* insertInto(void* node, int level, T* item, string& split_key);   //returns the right half if node split
+        bool eraseFrom(void* node, int level, T* item);                        //false if the item is not below node
+        void rebalance(Branch* branch, int index, int level);  //refill or merge the child at index of a branch at level
+        void destroy(void* node, int level);
+        size_t bytes(const void* node, int level) const;
+
+        OrderedIndex(const OrderedIndex&);
+        OrderedIndex& operator=(const OrderedIndex&);
+    public:
+        //a position in the index, moved to the right with next
+        class Cursor
+        {
+            private:
+                const Leaf* leaf;
+                int pos;
+                void skipEmpty() { while (leaf != nullptr && pos >= leaf->count) { leaf = leaf->next; pos = 0; } }
+            public:
+                Cursor(const Leaf* leaf, int pos) : leaf(leaf), pos(pos) { skipEmpty(); }
+                bool valid() const { return leaf != nullptr; }
+                T* get() const { return leaf->items[pos]; }
+                void next() { pos++; skipEmpty(); }
+        };
+
+        OrderedIndex();
+        ~OrderedIndex();
+        size_t size() const;                            //number of items
+        void insert(T* item);                           //add an item whose name is not in the index
+        bool erase(T* item);                            //false if the item is not present
+        Cursor begin() const;                           //the first item by name
+        Cursor lowerBound(const string& name) const;    //the first item whose name is not less than name
+        size_t memoryBytes() const;                     //memory held by the leaves and branches
+};
+//================================================
+
+template <typename T>
+const int OrderedIndex<T>::FANOUT;
+template <typename T>
+const int OrderedIndex<T>::MINIMUM;
+
+template <typename T>
+OrderedIndex<T>::OrderedIndex() : height(0), used(0) {
+    head = new Leaf();
+    head->count = 0;
+    head->next = nullptr;
+    root = head;
+}
+
+//destructor for freeing the leaves and branches, the items themselves are not owned
+template <typename T>
+OrderedIndex<T>::~OrderedIndex() {
+    destroy(root, height);
+}
+
+template <typename T>
+void OrderedIndex<T>::destroy(void* node, int level) {
+    if (level == 0) {
+        delete static_cast<Leaf*>(node);
+        return;
+    }
+    Branch* branch = static_cast<Branch*>(node);
+    for (int i = 0; i < branch->count; ++i) {
+        destroy(branch->child[i], level - 1);
+    }
+    delete branch;
+}
+
+template <typename T>
+size_t OrderedIndex<T>::size() const {
+    return used;
+}
+
+//the last child whose lower bound is not greater than name
+template <typename T>
+int OrderedIndex<T>::childFor(const Branch* branch, const string& name) {
+    int low = 1, high = branch->count;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (branch->first[mid].compare(name) <= 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low - 1;
+}
+
+template <typename T>
+int OrderedIndex<T>::leafPosition(const Leaf* leaf, const string& name) {
+    int low = 0, high = leaf->count;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (leaf->items[mid]->getName().compare(name) < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+//create a method that inserts below node and splits it in halves when it is full, passing the right half and its first name up
+template <typename T>
+void* OrderedIndex<T>::insertInto(void* node, int level, T* item, string& split_key) {
+    const string& name = item->getName();
+    if (level == 0) {
+        Leaf* leaf = static_cast<Leaf*>(node);
+        int pos = leafPosition(leaf, name);
+        if (leaf->count < FANOUT) {
+            memmove(leaf->items + pos + 1, leaf->items + pos, (leaf->count - pos) * sizeof(T*));
+            leaf->items[pos] = item;
+            leaf->count++;
+            return nullptr;
+        }
+        Leaf* right = new Leaf();
+        int half = FANOUT / 2;
+        right->count = FANOUT - half;
+        memcpy(right->items, leaf->items + half, right->count * sizeof(T*));
+        leaf->count = half;
+        right->next = leaf->next;
+        leaf->next = right;
+        Leaf* target = pos <= half ? leaf : right;
+        if (target == right) {
+            pos -= half;
+        }
+        memmove(target->items + pos + 1, target->items + pos, (target->count - pos) * sizeof(T*));
+        target->items[pos] = item;
+        target->count++;
+        split_key = right->items[0]->getName();
+        return right;
+    }
+
+    Branch* branch = static_cast<Branch*>(node);
+    int index = childFor(branch, name);
+    string key;
+    void* sibling = insertInto(branch->child[index], level - 1, item, key);
+    if (sibling == nullptr) {
+        return nullptr;
+    }
+
+    //the new child goes right after the one that split
+    int pos = index + 1;
+    Branch* target = branch;
+    Branch* right = nullptr;
+    if (branch->count == FANOUT) {
+        right = new Branch();
+        int half = FANOUT / 2;
+        right->count = FANOUT - half;
+        for (int i = 0; i < right->count; ++i) {
+            right->first[i].swap(branch->first[half + i]);
+            right->child[i] = branch->child[half + i];
+        }
+        branch->count = half;
+        if (pos > half) {
+            target = right;
+            pos -= half;
+        }
+    }
+    for (int i = target->count; i > pos; --i) {
+        target->first[i].swap(target->first[i - 1]);
+        target->child[i] = target->child[i - 1];
+    }
+    target->first[pos] = key;
+    target->child[pos] = sibling;
+    target->count++;
+    if (right == nullptr) {
+        return nullptr;
+    }
+    split_key = right->first[0];
+    return right;
+}
+
+//create a method that adds an item; a split of the root adds a level above it
+template <typename T>
+void OrderedIndex<T>::insert(T* item) {
+    string key;
+    void* sibling = insertInto(root, height, item, key);
+    used++;
+    if (sibling != nullptr) {
+        Branch* top = new Branch();
+        top->count = 2;
+        top->child[0] = root;
+        top->first[1] = key;
+        top->child[1] = sibling;
+        root = top;
+        height++;
+    }
+}
+
+//create a method that removes an item; a root branch left with one child is replaced by it
+template <typename T>
+bool OrderedIndex<T>::erase(T* item) {
+    if (!eraseFrom(root, height, item)) {
+        return false;
+    }
+    used--;
+    while (height > 0 && static_cast<Branch*>(root)->count == 1) {
+        Branch* top = static_cast<Branch*>(root);
+        root = top->child[0];
+        delete top;
+        height--;
+    }
+    return true;
+}
+
+//create a method that removes an item below node and rebalances the child it was removed from if it underflowed
+template <typename T>
+bool OrderedIndex<T>::eraseFrom(void* node, int level, T* item) {
+    const string& name = item->getName();
+    if (level == 0) {
+        Leaf* leaf = static_cast<Leaf*>(node);
+        int pos = leafPosition(leaf, name);
+        if (pos == leaf->count || leaf->items[pos] != item) {
+            return false;
+        }
+        memmove(leaf->items + pos, leaf->items + pos + 1, (leaf->count - pos - 1) * sizeof(T*));
+        leaf->count--;
+        return true;
+    }
+    Branch* branch = static_cast<Branch*>(node);
+    int index = childFor(branch, name);
+    if (!eraseFrom(branch->child[index], level - 1, item)) {
+        return false;
+    }
+    int count = level == 1 ? static_cast<Leaf*>(branch->child[index])->count : static_cast<Branch*>(branch->child[index])->count;
+    if (count < MINIMUM && branch->count > 1) {
+        rebalance(branch, index, level);
+    }
+    return true;
+}
+
+//create a method that evens out the child at index with a neighbour, or merges the right one of the two into the left one when they fit in one node
+template <typename T>
+void OrderedIndex<T>::rebalance(Branch* branch, int index, int level) {
+    int right = index > 0 ? index : index + 1;//the left one of the pair is right - 1
+    if (level == 1) {
+        Leaf* a = static_cast<Leaf*>(branch->child[right - 1]);
+        Leaf* b = static_cast<Leaf*>(branch->child[right]);
+        int total = a->count + b->count;
+        if (total <= FANOUT) {
+            memcpy(a->items + a->count, b->items, b->count * sizeof(T*));
+            a->count = total;
+            a->next = b->next;
+            delete b;
+        } else {
+            int keep = total / 2;
+            if (a->count > keep) {//a gives its last items to the front of b
+                int moved = a->count - keep;
+                memmove(b->items + moved, b->items, b->count * sizeof(T*));
+                memcpy(b->items, a->items + keep, moved * sizeof(T*));
+                b->count += moved;
+            } else {//b gives its first items to the end of a
+                int moved = keep - a->count;
+                memcpy(a->items + a->count, b->items, moved * sizeof(T*));
+                memmove(b->items, b->items + moved, (b->count - moved) * sizeof(T*));
+                b->count -= moved;
+            }
+            a->count = keep;
+            branch->first[right] = b->items[0]->getName();
+            return;
+        }
+    } else {
+        //the children of both, with the separator between them as the lower bound of b's first child
+        Branch* a = static_cast<Branch*>(branch->child[right - 1]);
+        Branch* b = static_cast<Branch*>(branch->child[right]);
+        int total = a->count + b->count;
+        if (total <= FANOUT) {
+            a->first[a->count].swap(branch->first[right]);
+            a->child[a->count] = b->child[0];
+            for (int i = 1; i < b->count; ++i) {
+                a->first[a->count + i].swap(b->first[i]);
+                a->child[a->count + i] = b->child[i];
+            }
+            a->count = total;
+            delete b;
+        } else {
+            vector<string> first(total);
+            vector<void*> child(total);
+            for (int i = 0; i < a->count; ++i) {
+                first[i].swap(a->first[i]);
+                child[i] = a->child[i];
+            }
+            first[a->count].swap(branch->first[right]);
+            child[a->count] = b->child[0];
+            for (int i = 1; i < b->count; ++i) {
+                first[a->count + i].swap(b->first[i]);
+                child[a->count + i] = b->child[i];
+            }
+            int keep = total / 2;
+            for (int i = 0; i < keep; ++i) {
+                a->first[i].swap(first[i]);
+                a->child[i] = child[i];
+            }
+            branch->first[right].swap(first[keep]);
+            b->first[0].clear();
+            b->child[0] = child[keep];
+            for (int i = keep + 1; i < total; ++i) {
+                b->first[i - keep].swap(first[i]);
+                b->child[i - keep] = child[i];
+            }
+            a->count = keep;
+            b->count = total - keep;
+            return;
+        }
+    }
+
+    //the merged right child is taken out of the branch
+    for (int i = right; i + 1 < branch->count; ++i) {
+        branch->first[i].swap(branch->first[i + 1]);
+        branch->child[i] = branch->child[i + 1];
+    }
+    branch->count--;
+    branch->first[branch->count].clear();
+}
+
+template <typename T>
+typename OrderedIndex<T>::Cursor OrderedIndex<T>::begin() const {
+    return Cursor(head, 0);
+}
+
+template <typename T>
+typename OrderedIndex<T>::Cursor OrderedIndex<T>::lowerBound(const string& name) const {
+    const void* node = root;
+    for (int level = height; level > 0; --level) {
+        const Branch* branch = static_cast<const Branch*>(node);
+        node = branch->child[childFor(branch, name)];
+    }
+    const Leaf* leaf = static_cast<const Leaf*>(node);
+    return Cursor(leaf, leafPosition(leaf, name));
+}
+
+template <typename T>
+size_t OrderedIndex<T>::memoryBytes() const {
+    return bytes(root, height);
+}
+
+template <typename T>
+size_t OrderedIndex<T>::bytes(const void* node, int level) const {
+    if (level == 0) {
+        return sizeof(Leaf);
+    }
+    const Branch* branch = static_cast<const Branch*>(node);
+    size_t total = sizeof(Branch);
+    for (int i = 0; i < branch->count; ++i) {
+        if (branch->first[i].capacity() > 15) {
+            total += branch->first[i].capacity() + 1;
+        }
+        total += bytes(branch->child[i], level - 1);
+    }
+    return total;
+}
+
+#endif
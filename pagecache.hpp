@@ -0,0 +1,367 @@
+//============================================================================
+// Name         : pagecache.hpp
+// Author       : Aysa Binte masud
+// Version      : 01
+// Date Created : 17 October 2026
+// Date Modified: 17 October 2026
+// Description  : Fixed-size page cache over a host block file in C++
+//============================================================================
+//
+// The blocks of the file store live in one host file, and a fixed number
+// of 4 KB frames hold the blocks in use. A block is pinned while it is read
+// or written, so its frame is not taken; a miss takes the frame the CLOCK
+// hand stops at (the first one that is neither pinned nor referenced since
+// the hand last passed it). A dirty frame is written back together with the
+// other dirty frames in the next WRITE_BATCH the hand will reach: they are
+// sorted by block and every run of consecutive blocks is one pwritev. A
+// read miss also reads the following blocks of the same extent that are not
+// cached, with one preadv, and a block that is about to be overwritten
+// whole, or was never written, is not read at all. Blocks that are freed
+// are dropped without being written. Every method takes the cache's mutex,
+// and the reads and writes of the host file are done under it.
+//
+#ifndef PAGECACHE_H
+#define PAGECACHE_H
+#include<cerrno>
+#include<cstdint>
+#include<cstring>
+#include<string>
+#include<vector>
+#include<unordered_map>
+#include<mutex>
+#include<algorithm>
+#include<stdexcept>
+#include<fcntl.h>
+#include<unistd.h>
+#include<sys/mman.h>
+#include<sys/uio.h>
+using namespace std;
+
+const uint64_t PAGE_BYTES = 4096;           //size of a block and of a frame
+const uint64_t DEFAULT_CACHE_BYTES = 256 << 20;
+
+//what the cache has done since it was made
+struct CacheStats
+{
+    uint64_t frames;                //capacity
+    uint64_t used;                  //frames holding a block
+    uint64_t dirty;                 //frames not written back yet
+    uint64_t hits, misses;
+    uint64_t evictions;             //blocks whose frame was taken for another
+    uint64_t written, write_calls;  //blocks written back and the pwritev calls that wrote them
+    uint64_t read, read_calls;      //blocks read and the preadv calls that read them
+    uint64_t file_bytes;            //length of the host file
+};
+
+class PageCache
+{
+    public:
+        static const uint32_t NONE = 0xFFFFFFFF;
+
+        //a pinned block; the frame stays its own until it is unpinned
+        struct Page
+        {
+            char* data;
+            uint32_t frame;
+        };
+    private:
+        static const uint64_t NO_BLOCK = ~0ULL;
+        static const uint32_t WRITE_BATCH = 1024;  //frames ahead of the hand whose dirty blocks are written with a dirty victim
+        static const int MAX_IOV = 256;
+
+        struct Frame
+        {
+            uint64_t block;             //NO_BLOCK while the frame is free
+            uint32_t pins;
+            bool dirty;
+            bool referenced;            //used since the hand last passed
+        };
+
+        string path;                    //the host file, unlinked as soon as it is open
+        int fd;                         //-1 until the first block is used
+        uint64_t file_bytes;
+        char* memory;                   //the frames, nullptr until the first pin
+        vector<Frame> frames;
+        uint64_t capacity;              //number of frames
+        uint32_t hand;                  //where CLOCK looks for the next victim
+        unordered_map<uint64_t, uint32_t> where;    //frame of every cached block
+        CacheStats counts;
+        mutex lock;
+
+        void openFile();
+        uint32_t victim();                              //a free frame, writing back what it held
+        void writeBack(vector<uint32_t>& dirty);        //write dirty frames in runs of consecutive blocks
+        void transfer(bool writing, uint64_t block, const vector<uint32_t>& run);  //one pwritev or preadv of consecutive blocks
+        void release();
+
+        PageCache(const PageCache&);
+        PageCache& operator=(const PageCache&);
+    public:
+        PageCache(const string& path, uint64_t bytes = DEFAULT_CACHE_BYTES);
+        ~PageCache();
+        Page pin(uint64_t block, bool fresh, uint64_t ahead);  //fresh: the block's contents do not matter; ahead: blocks after it to read on a miss
+        void unpin(const Page& page, bool dirty);
+        void grow(uint64_t bytes);                      //make the host file at least this long
+        void discard(uint64_t first, uint64_t count);   //the blocks were freed, what they hold is dropped
+        bool resize(uint64_t bytes);                    //write back everything and start over with another capacity, false while pages are pinned
+        void reset();                                   //drop every block and empty the host file
+        CacheStats stats();
+};
+//================================================
+
+const uint32_t PageCache::NONE;
+const uint64_t PageCache::NO_BLOCK;
+const uint32_t PageCache::WRITE_BATCH;
+const int PageCache::MAX_IOV;
+
+PageCache::PageCache(const string& path, uint64_t bytes) : path(path), fd(-1), file_bytes(0), memory(nullptr), capacity(max(bytes / PAGE_BYTES, (uint64_t)16)), hand(0) {
+    memset(&counts, 0, sizeof(counts));
+}
+
+PageCache::~PageCache() {
+    release();
+    if (fd >= 0) {
+        ::close(fd);
+    }
+}
+
+//create a method that creates the host file on first use; it is unlinked at once, so it goes away with the process
+void PageCache::openFile() {
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0) {
+        throw runtime_error("could not create the block file '" + path + "'");
+    }
+    unlink(path.c_str());
+}
+
+void PageCache::release() {
+    if (memory != nullptr) {
+        munmap(memory, capacity * PAGE_BYTES);
+        memory = nullptr;
+    }
+    frames.clear();
+    where.clear();
+    hand = 0;
+}
+
+//create a method that moves the CLOCK hand to a frame that is free or neither pinned nor referenced, writing it back with its dirty neighbours
+uint32_t PageCache::victim() {
+    if (memory == nullptr) {
+        void* mapped = mmap(nullptr, capacity * PAGE_BYTES, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (mapped == MAP_FAILED) {
+            throw bad_alloc();
+        }
+        memory = static_cast<char*>(mapped);
+        Frame empty = {NO_BLOCK, 0, false, false};
+        frames.assign(capacity, empty);
+    }
+    for (uint64_t steps = 0; steps < 2 * capacity + 1; ++steps) {
+        uint32_t f = hand;
+        hand = (hand + 1) % capacity;
+        Frame& frame = frames[f];
+        if (frame.block == NO_BLOCK) {
+            return f;
+        }
+        if (frame.pins > 0) {
+            continue;
+        }
+        if (frame.referenced) {//a second chance
+            frame.referenced = false;
+            continue;
+        }
+        if (frame.dirty) {
+            vector<uint32_t> dirty(1, f);
+            for (uint32_t k = 0, g = hand; k < WRITE_BATCH && k < capacity; ++k, g = (g + 1) % capacity) {
+                if (g != f && frames[g].dirty && frames[g].pins == 0) {
+                    dirty.push_back(g);
+                }
+            }
+            writeBack(dirty);
+        }
+        where.erase(frame.block);
+        frame.block = NO_BLOCK;
+        counts.evictions++;
+        return f;
+    }
+    throw runtime_error("every page of the cache is pinned");
+}
+
+void PageCache::writeBack(vector<uint32_t>& dirty) {
+    sort(dirty.begin(), dirty.end(), [this](uint32_t a, uint32_t b) { return frames[a].block < frames[b].block; });
+    vector<uint32_t> run;
+    for (size_t i = 0; i < dirty.size(); ++i) {
+        run.push_back(dirty[i]);
+        bool last = i + 1 == dirty.size() || frames[dirty[i + 1]].block != frames[dirty[i]].block + 1 || run.size() == (size_t)MAX_IOV;
+        if (last) {
+            transfer(true, frames[run[0]].block, run);
+            run.clear();
+        }
+    }
+    for (size_t i = 0; i < dirty.size(); ++i) {
+        frames[dirty[i]].dirty = false;
+    }
+}
+
+//create a method that writes or reads frames holding consecutive blocks with one system call, repeated only for what a short transfer left
+void PageCache::transfer(bool writing, uint64_t block, const vector<uint32_t>& run) {
+    iovec iov[MAX_IOV];
+    for (size_t i = 0; i < run.size(); ++i) {
+        iov[i].iov_base = memory + run[i] * PAGE_BYTES;
+        iov[i].iov_len = PAGE_BYTES;
+    }
+    int count = run.size();
+    iovec* next = iov;
+    off_t offset = block * PAGE_BYTES;
+    while (count > 0) {
+        ssize_t n = writing ? pwritev(fd, next, count, offset) : preadv(fd, next, count, offset);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0 || (n == 0 && writing)) {
+            throw runtime_error(writing ? "could not write the block file" : "could not read the block file");
+        }
+        if (n == 0) {//past the end of the file, the rest reads as zeros
+            for (int i = 0; i < count; ++i) {
+                memset(next[i].iov_base, 0, next[i].iov_len);
+            }
+            break;
+        }
+        offset += n;
+        while (count > 0 && (size_t)n >= next->iov_len) {
+            n -= next->iov_len;
+            next++;
+            count--;
+        }
+        if (count > 0) {
+            next->iov_base = static_cast<char*>(next->iov_base) + n;
+            next->iov_len -= n;
+        }
+    }
+    if (writing) {
+        counts.written += run.size();
+        counts.write_calls++;
+    } else {
+        counts.read += run.size();
+        counts.read_calls++;
+    }
+}
+
+//create a method that pins a block, taking a frame for it on a miss, and reads it (with the blocks after it) unless its contents do not matter
+PageCache::Page PageCache::pin(uint64_t block, bool fresh, uint64_t ahead) {
+    lock_guard<mutex> guard(lock);
+    unordered_map<uint64_t, uint32_t>::iterator it = where.find(block);
+    if (it != where.end()) {
+        Frame& frame = frames[it->second];
+        frame.pins++;
+        frame.referenced = true;
+        counts.hits++;
+        Page page = {memory + it->second * PAGE_BYTES, it->second};
+        return page;
+    }
+    counts.misses++;
+    if (fd < 0) {
+        openFile();
+    }
+
+    uint32_t f = victim();
+    Frame& frame = frames[f];
+    frame.block = block;
+    frame.pins = 1;
+    frame.dirty = false;
+    frame.referenced = true;
+    where[block] = f;
+    if (!fresh) {
+        //the blocks after it that are not cached come in the same read, unpinned
+        vector<uint32_t> run(1, f);
+        frame.pins++;//so that taking frames for them cannot take this one
+        for (uint64_t k = 1; k <= ahead && run.size() < (size_t)MAX_IOV && where.find(block + k) == where.end(); ++k) {
+            uint32_t g = victim();
+            Frame ahead_frame = {block + k, 1, false, false};
+            frames[g] = ahead_frame;
+            where[block + k] = g;
+            run.push_back(g);
+        }
+        transfer(false, block, run);
+        for (size_t i = 0; i < run.size(); ++i) {
+            frames[run[i]].pins--;
+        }
+    }
+    Page page = {memory + f * PAGE_BYTES, f};
+    return page;
+}
+
+void PageCache::unpin(const Page& page, bool dirty) {
+    lock_guard<mutex> guard(lock);
+    Frame& frame = frames[page.frame];
+    frame.pins--;
+    frame.dirty = frame.dirty || dirty;
+}
+
+//create a method that lengthens the host file; the new blocks take no disk space until they are written
+void PageCache::grow(uint64_t bytes) {
+    lock_guard<mutex> guard(lock);
+    if (fd < 0) {
+        openFile();
+    }
+    if (bytes > file_bytes && ftruncate(fd, bytes) == 0) {
+        file_bytes = bytes;
+    }
+}
+
+void PageCache::discard(uint64_t first, uint64_t count) {
+    lock_guard<mutex> guard(lock);
+    if (where.empty()) {
+        return;
+    }
+    for (uint64_t block = first; block < first + count; ++block) {
+        unordered_map<uint64_t, uint32_t>::iterator it = where.find(block);
+        if (it != where.end()) {
+            Frame& frame = frames[it->second];
+            frame.block = NO_BLOCK;
+            frame.dirty = false;
+            frame.referenced = false;
+            where.erase(it);
+        }
+    }
+}
+
+//create a method that writes back every dirty frame and gives the cache another number of frames
+bool PageCache::resize(uint64_t bytes) {
+    lock_guard<mutex> guard(lock);
+    vector<uint32_t> dirty;
+    for (uint32_t f = 0; f < frames.size(); ++f) {
+        if (frames[f].pins > 0) {
+            return false;
+        }
+        if (frames[f].dirty) {
+            dirty.push_back(f);
+        }
+    }
+    writeBack(dirty);
+    release();
+    capacity = max(bytes / PAGE_BYTES, (uint64_t)16);
+    return true;
+}
+
+void PageCache::reset() {
+    lock_guard<mutex> guard(lock);
+    release();
+    if (fd >= 0 && ftruncate(fd, 0) == 0) {
+        file_bytes = 0;
+    }
+}
+
+CacheStats PageCache::stats() {
+    lock_guard<mutex> guard(lock);
+    CacheStats out = counts;
+    out.frames = capacity;
+    out.used = where.size();
+    out.dirty = 0;
+    for (size_t f = 0; f < frames.size(); ++f) {
+        out.dirty += frames[f].dirty;
+    }
+    out.file_bytes = file_bytes;
+    return out;
+}
+
+#endif
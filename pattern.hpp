@@ -0,0 +1,125 @@
+//============================================================================
+// Name         : pattern.hpp
+// Author       : Aysa Binte masud
+// Version      : 01
+// Date Created : 17 October 2026
+// Date Modified: 17 October 2026
+// Description  : Wildcard and regular expression name patterns in C++
+//============================================================================
+//
+// A wildcard pattern supports * (any run of characters), ? (any one
+// character) and [...] sets with ranges, negated by a leading ! or ^. A
+// regular expression uses the ECMAScript grammar and has to match the whole
+// name. A compiled pattern is only read while matching, so several threads
+// can share it.
+//
+#ifndef PATTERN_H
+#define PATTERN_H
+#include<cstring>
+#include<string>
+#include<regex>
+using namespace std;
+
+class NamePattern
+{
+    private:
+        string glob;            //the wildcard pattern, if it is one
+        bool is_regex;          //true for a regular expression
+        regex expression;       //the compiled regular expression
+
+        static bool matchSet(const char*& p, const char* end, char c); //match c against the set starting at p, moving p past it
+    public:
+        NamePattern(const string& pattern, bool is_regex);  //throws regex_error for a bad expression
+        bool match(const char* name, size_t length) const;
+        bool match(const string& name) const;
+        static bool isWildcard(const string& pattern);      //true if the pattern contains * ? or [
+};
+//================================================
+
+NamePattern::NamePattern(const string& pattern, bool is_regex) : glob(pattern), is_regex(is_regex) {
+    if (is_regex) {
+        expression = regex(pattern, regex::ECMAScript | regex::optimize);
+    }
+}
+
+bool NamePattern::isWildcard(const string& pattern) {
+    return pattern.find_first_of("*?[") != string::npos;
+}
+
+//create a method that matches one [...] set; a set without its closing bracket matches a literal '['
+bool NamePattern::matchSet(const char*& p, const char* end, char c) {
+    const char* q = p + 1;
+    bool negate = q < end && (*q == '!' || *q == '^');
+    if (negate) {
+        q++;
+    }
+    bool found = false;
+    const char* first = q;
+    while (q < end && (*q != ']' || q == first)) {
+        if (q + 2 < end && q[1] == '-' && q[2] != ']') {
+            found |= (c >= q[0] && c <= q[2]);
+            q += 3;
+        } else {
+            found |= (c == *q);
+            q++;
+        }
+    }
+    if (q >= end) {
+        p++;
+        return c == '[';
+    }
+    p = q + 1;
+    return found != negate;
+}
+
+//create a method that matches a wildcard pattern without recursion, going back to the last * on a mismatch
+bool NamePattern::match(const char* name, size_t length) const {
+    if (is_regex) {
+        return regex_match(name, name + length, expression);
+    }
+
+    const char* p = glob.data();
+    const char* p_end = p + glob.size();
+    const char* s = name;
+    const char* s_end = name + length;
+    const char* star = nullptr;     //position after the last * in the pattern
+    const char* resume = nullptr;   //where that * starts matching in the name
+
+    while (s < s_end) {
+        if (p < p_end && *p == '*') {
+            star = ++p;
+            resume = s;
+            continue;
+        }
+        if (p < p_end) {
+            const char* next = p;
+            bool ok;
+            if (*p == '[') {
+                ok = matchSet(next, p_end, *s);
+            } else {
+                ok = (*p == '?' || *p == *s);
+                next = p + 1;
+            }
+            if (ok) {
+                p = next;
+                s++;
+                continue;
+            }
+        }
+        if (star == nullptr) {
+            return false;
+        }
+        p = star;//let the * take one more character
+        s = ++resume;
+    }
+    while (p < p_end && *p == '*') {
+        p++;
+    }
+    return p == p_end;
+}
+
+bool NamePattern::match(const string& name) const {
+    return match(name.data(), name.size());
+}
+
+#endif
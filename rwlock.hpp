@@ -0,0 +1,198 @@
+//============================================================================
+// Name         : rwlock.hpp
+// Author       : Aysa Binte masud
+// Version      : 01
+// Date Created : 17 October 2026
+// Date Modified: 17 October 2026
+// Description  : Reader-writer locks used by the sessions of a VFS in C++
+//============================================================================
+//
+// SpinRWLock is the lock of one folder. It is a single 32-bit word, so every
+// Inode can carry one: the low bit is set while a writer holds it, the next
+// bit while a writer waits (which keeps new readers out, so writers are not
+// starved), and the rest counts the readers. Waiting yields the processor.
+// RWLock is the namespace lock: a blocking pthread lock whose exclusive side
+// may be taken again, shared or exclusive, by the thread that holds it, so a
+// command that holds it can call other commands. A background thread tries
+// its shared side instead of waiting for it, so a command holding it can
+// tell that thread to stop and wait for it without a deadlock.
+//
+#ifndef RWLOCK_H
+#define RWLOCK_H
+#include<cstdint>
+#include<atomic>
+#include<thread>
+#include<pthread.h>
+using namespace std;
+
+class SpinRWLock
+{
+    private:
+        static const uint32_t WRITER = 1;
+        static const uint32_t WAITING = 2;
+        static const uint32_t READER = 4;
+        atomic<uint32_t> state;
+
+        SpinRWLock(const SpinRWLock&);
+        SpinRWLock& operator=(const SpinRWLock&);
+    public:
+        SpinRWLock();
+        void lock_shared();
+        void unlock_shared();
+        void lock();
+        void unlock();
+};
+
+class RWLock
+{
+    private:
+        pthread_rwlock_t rwlock;
+        atomic<thread::id> owner;       //thread holding the exclusive side, none otherwise
+        unsigned depth;                 //how many times the owner took it
+
+        RWLock(const RWLock&);
+        RWLock& operator=(const RWLock&);
+    public:
+        RWLock();
+        ~RWLock();
+        void lock_shared();
+        bool try_lock_shared();     //take the shared side if no writer holds it, without waiting
+        void unlock_shared();
+        void lock();
+        void unlock();
+};
+
+//holds the shared side of a lock for a scope
+template <typename L>
+class SharedGuard
+{
+    private:
+        L& lock;
+        SharedGuard(const SharedGuard&);
+        SharedGuard& operator=(const SharedGuard&);
+    public:
+        explicit SharedGuard(L& lock) : lock(lock) { lock.lock_shared(); }
+        ~SharedGuard() { lock.unlock_shared(); }
+};
+
+//holds the exclusive side of a lock for a scope
+template <typename L>
+class ExclusiveGuard
+{
+    private:
+        L& lock;
+        ExclusiveGuard(const ExclusiveGuard&);
+        ExclusiveGuard& operator=(const ExclusiveGuard&);
+    public:
+        explicit ExclusiveGuard(L& lock) : lock(lock) { lock.lock(); }
+        ~ExclusiveGuard() { lock.unlock(); }
+};
+//holds the shared side of a lock for a scope, or the exclusive side after upgrade; upgrading lets go of the shared side first, so what was read under it has to be read again
+template <typename L>
+class UpgradeGuard
+{
+    private:
+        L& lock;
+        bool exclusive;
+        UpgradeGuard(const UpgradeGuard&);
+        UpgradeGuard& operator=(const UpgradeGuard&);
+    public:
+        explicit UpgradeGuard(L& lock) : lock(lock), exclusive(false) { lock.lock_shared(); }
+        void upgrade() { if (!exclusive) { lock.unlock_shared(); lock.lock(); exclusive = true; } }
+        ~UpgradeGuard() { if (exclusive) { lock.unlock(); } else { lock.unlock_shared(); } }
+};
+//================================================
+
+const uint32_t SpinRWLock::WRITER;
+const uint32_t SpinRWLock::WAITING;
+const uint32_t SpinRWLock::READER;
+
+SpinRWLock::SpinRWLock() : state(0) {
+}
+
+//create a method that adds a reader once no writer holds or waits for the lock
+void SpinRWLock::lock_shared() {
+    while (true) {
+        uint32_t s = state.load(memory_order_relaxed);
+        if ((s & (WRITER | WAITING)) == 0 && state.compare_exchange_weak(s, s + READER, memory_order_acquire, memory_order_relaxed)) {
+            return;
+        }
+        this_thread::yield();
+    }
+}
+
+void SpinRWLock::unlock_shared() {
+    state.fetch_sub(READER, memory_order_release);
+}
+
+//create a method that announces the writer, then takes the lock once the readers are gone
+void SpinRWLock::lock() {
+    while (true) {
+        uint32_t s = state.load(memory_order_relaxed);
+        if ((s & ~WAITING) == 0) {
+            if (state.compare_exchange_weak(s, WRITER, memory_order_acquire, memory_order_relaxed)) {
+                return;
+            }
+        } else if ((s & WAITING) == 0) {
+            state.compare_exchange_weak(s, s | WAITING, memory_order_relaxed, memory_order_relaxed);
+        }
+        this_thread::yield();
+    }
+}
+
+//another writer may have set WAITING meanwhile, so only the writer bit is cleared
+void SpinRWLock::unlock() {
+    state.fetch_and(~WRITER, memory_order_release);
+}
+
+RWLock::RWLock() : owner(thread::id()), depth(0) {
+    pthread_rwlock_init(&rwlock, nullptr);
+}
+
+RWLock::~RWLock() {
+    pthread_rwlock_destroy(&rwlock);
+}
+
+//inside the exclusive side the thread already excludes everyone, so it only counts
+void RWLock::lock_shared() {
+    if (owner.load(memory_order_relaxed) == this_thread::get_id()) {
+        depth++;
+        return;
+    }
+    pthread_rwlock_rdlock(&rwlock);
+}
+
+bool RWLock::try_lock_shared() {
+    if (owner.load(memory_order_relaxed) == this_thread::get_id()) {
+        depth++;
+        return true;
+    }
+    return pthread_rwlock_tryrdlock(&rwlock) == 0;
+}
+
+void RWLock::unlock_shared() {
+    if (owner.load(memory_order_relaxed) == this_thread::get_id()) {
+        depth--;
+        return;
+    }
+    pthread_rwlock_unlock(&rwlock);
+}
+
+void RWLock::lock() {
+    if (owner.load(memory_order_relaxed) == this_thread::get_id()) {
+        depth++;
+        return;
+    }
+    pthread_rwlock_wrlock(&rwlock);
+    owner.store(this_thread::get_id(), memory_order_relaxed);
+    depth = 1;
+}
+
+void RWLock::unlock() {
+    if (--depth == 0) {
+        owner.store(thread::id(), memory_order_relaxed);
+        pthread_rwlock_unlock(&rwlock);
+    }
+}
+
+#endif
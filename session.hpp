@@ -0,0 +1,54 @@
+//============================================================================
+// Name         : session.hpp
+// Author       : Aysa Binte masud
+// Version      : 01
+// Date Created : 17 October 2026
+// Date Modified: 17 October 2026
+// Description  : Per-user state of a VFS shared by several sessions in C++
+//============================================================================
+//
+// A session is what one user of a VFS has to themselves: the current and
+// previous folders and the stream the commands print to. The tree belongs
+// to the VFS and is shared by all its sessions. Next to each folder the
+// session keeps the folder's Inode number and the mount it was taken in, so
+// the VFS can tell when another session removed or purged the folder (or a
+// mount replaced the tree) and move this session back to the root. A
+// folder inside a copy that was not expanded has no Inode of its own yet,
+// so the session keeps the copy and the path below it; reading the folder
+// does not expand the copy, only a change made in it does.
+//
+#ifndef SESSION_H
+#define SESSION_H
+#include<iostream>
+#include<cstdint>
+#include<string>
+#include "inode.hpp"
+using namespace std;
+
+class Session
+{
+    private:
+        Inode *curr_inode;          //current folder, nullptr until the session first runs a command
+        Inode *prev_inode;          //previous folder for cd -
+        uint64_t curr_ino;          //Inode numbers of the two folders
+        uint64_t prev_ino;
+        string curr_below;          //path below the folder inside a copy that was not expanded, empty if the folder is the one
+        string prev_below;
+        uint64_t mount_epoch;       //mount of the VFS both folders belong to
+        ostream *out;               //where the commands of the session print
+
+        friend class VFS;
+    public:
+        Session(ostream& out = cout);
+        ostream& output();
+};
+//================================================
+
+Session::Session(ostream& out) : curr_inode(nullptr), prev_inode(nullptr), curr_ino(0), prev_ino(0), mount_epoch(0), out(&out) {
+}
+
+ostream& Session::output() {
+    return *out;
+}
+
+#endif
@@ -0,0 +1,264 @@
+//============================================================================
+// Name         : shell.hpp
+// Author       : Aysa Binte masud
+// Version      : 01
+// Date Created : 17 October 2026
+// Date Modified: 17 October 2026
+// Description  : Command table, tokenizer and batch mode of the VFS shell
+//============================================================================
+//
+// A command line is split the way the shell always split it: the command
+// up to the first space, the first parameter up to the next one and the
+// second parameter is the rest of the line. The pieces are tokens, a
+// pointer and a length into the line, so splitting allocates nothing. The
+// command is looked up in a HashIndex of handlers, one probe per line.
+// In batch mode (--batch script, or a script piped into the shell) lines
+// come from a LineReader, no prompt is printed, and cout goes to a buffer
+// that ignores the flushes of endl and is written out in 1 MB blocks.
+//
+#ifndef SHELL_H
+#define SHELL_H
+#include<iostream>
+#include<cstdio>
+#include<cstdlib>
+#include<cstring>
+#include<cerrno>
+#include<string>
+#include<vector>
+#include<chrono>
+#include<unistd.h>
+#include "vfs.hpp"
+#include "hash.hpp"
+#include "hashindex.hpp"
+#include "loader.hpp"
+#include "stats.hpp"
+using namespace std;
+
+//a piece of a command line
+struct Token
+{
+    const char* data;
+    size_t length;
+
+    string str() const { return string(data, length); }
+    bool is(const char* word) const { return length == strlen(word) && memcmp(data, word, length) == 0; }
+};
+
+//split a line into the command, the first parameter and the rest of the line
+inline void splitCommand(const char* line, size_t length, Token& command, Token& parameter1, Token& parameter2) {
+    const char* end = line + length;
+    const char* space = static_cast<const char*>(memchr(line, ' ', length));
+    command.data = line;
+    command.length = (space != nullptr ? space : end) - line;
+
+    const char* p = space != nullptr ? space + 1 : end;
+    space = static_cast<const char*>(memchr(p, ' ', end - p));
+    parameter1.data = p;
+    parameter1.length = (space != nullptr ? space : end) - p;
+
+    parameter2.data = space != nullptr ? space + 1 : end;
+    parameter2.length = end - parameter2.data;
+}
+
+class CommandTable
+{
+    public:
+        typedef void (*Handler)(VFS& vfs, const Token& parameter1, const Token& parameter2);
+    private:
+        struct Command
+        {
+            string name;
+            uint64_t name_hash;
+            Handler run;
+            unsigned stat;              //histogram of its latency
+
+            const string& getName() const { return name; }
+            uint64_t getNameHash() const { return name_hash; }
+        };
+
+        HashIndex<Command> index;       //the commands by name
+        vector<Command> commands;       //where they live, filled once before they are indexed
+
+        CommandTable(const CommandTable&);
+        CommandTable& operator=(const CommandTable&);
+    public:
+        CommandTable();
+        bool execute(VFS& vfs, const char* line, size_t length);   //run one line, false for exit
+};
+
+//collects everything written to it; a flush (endl) does nothing, the data is written when 1 MB has gathered or by writeOut
+class BatchOutput : public streambuf
+{
+    private:
+        static const size_t BLOCK = 1 << 20;
+        char *block;                    //the put area of the stream
+        int fd;                         //where the blocks are written
+
+        BatchOutput(const BatchOutput&);
+        BatchOutput& operator=(const BatchOutput&);
+    protected:
+        int overflow(int c);
+        int sync();
+    public:
+        BatchOutput(int fd = STDOUT_FILENO);
+        ~BatchOutput();
+        void writeOut();                //write what has gathered
+};
+
+//run every line of a script, then report the commands per second on stderr; returns at the end of the script or at exit
+inline void runBatch(VFS& vfs, CommandTable& commands, const string& script, BatchOutput& output);
+//================================================
+
+//create a constructor that registers every command of the shell, each with a handler that turns its tokens into the call
+CommandTable::CommandTable() {
+    struct { const char* name; Handler run; } table[] = {
+        //Required commands
+        {"help", [](VFS& vfs, const Token&, const Token&) { vfs.help(); }},
+        {"pwd", [](VFS& vfs, const Token&, const Token&) { cout << vfs.pwd() << endl; }},
+        {"ls", [](VFS& vfs, const Token& p1, const Token& p2) { vfs.ls(string(p1.data, p2.data + p2.length - p1.data)); }},
+        {"mkdir", [](VFS& vfs, const Token& p1, const Token&) { vfs.mkdir(p1.str()); }},
+        {"touch", [](VFS& vfs, const Token& p1, const Token& p2) { vfs.touch(p1.str(), stoi(p2.str())); }},
+        {"cd", [](VFS& vfs, const Token& p1, const Token&) { vfs.cd(p1.str()); }},
+        {"rm", [](VFS& vfs, const Token& p1, const Token&) { vfs.rm(p1.str()); }},
+        {"size", [](VFS& vfs, const Token& p1, const Token&) { vfs.size(p1.str()); }},
+        {"showbin", [](VFS& vfs, const Token&, const Token&) { vfs.showbin(); }},
+        {"emptybin", [](VFS& vfs, const Token&, const Token&) { vfs.emptybin(); }},
+
+        //optional commands
+        {"find", [](VFS& vfs, const Token& p1, const Token& p2) { p1.is("-r") ? vfs.findPattern(p2.str(), true) : vfs.find(p1.str()); }},
+        {"mv", [](VFS& vfs, const Token& p1, const Token& p2) { vfs.mv(p1.str(), p2.str()); }},
+        {"cp", [](VFS& vfs, const Token& p1, const Token& p2) {
+            if (!p1.is("-r")) {
+                vfs.cp(p1.str(), p2.str(), false);
+                return;
+            }
+            //with -r the source and the destination are both in the rest of the line
+            const char* space = static_cast<const char*>(memchr(p2.data, ' ', p2.length));
+            size_t length = space != nullptr ? space - p2.data : p2.length;
+            vfs.cp(string(p2.data, length), space != nullptr ? string(space + 1, p2.data + p2.length - space - 1) : "", true);
+        }},
+        {"recover", [](VFS& vfs, const Token& p1, const Token&) { vfs.recover(p1.str()); }},
+        {"arena", [](VFS& vfs, const Token&, const Token&) { vfs.arena(); }},
+        {"compact", [](VFS& vfs, const Token&, const Token&) { vfs.compact(); }},
+        {"load", [](VFS& vfs, const Token& p1, const Token&) { vfs.load(p1.str()); }},
+        {"save", [](VFS& vfs, const Token& p1, const Token&) { vfs.save(p1.length == 0 ? "vfs.snap" : p1.str()); }},
+        {"mount", [](VFS& vfs, const Token& p1, const Token&) { vfs.mount(p1.length == 0 ? "vfs.snap" : p1.str()); }},
+        {"checkpoint", [](VFS& vfs, const Token& p1, const Token&) { vfs.checkpointCommand(p1.str()); }},
+        {"journal", [](VFS& vfs, const Token& p1, const Token&) { vfs.journalCommand(p1.str()); }},
+        {"dcache", [](VFS& vfs, const Token&, const Token&) { vfs.dcache(); }},
+        {"binlimit", [](VFS& vfs, const Token& p1, const Token& p2) { vfs.binlimit(p1.str(), p2.str()); }},
+        {"stats", [](VFS& vfs, const Token& p1, const Token& p2) { vfs.stats(p1.str(), p2.str()); }},
+        {"snapshot", [](VFS& vfs, const Token& p1, const Token& p2) { vfs.snapshotCommand(p1.str(), p2.str()); }},
+        {"write", [](VFS& vfs, const Token& p1, const Token& p2) { vfs.writeFile(p1.str(), p2.str(), false); }},
+        {"append", [](VFS& vfs, const Token& p1, const Token& p2) { vfs.writeFile(p1.str(), p2.str(), true); }},
+        {"cat", [](VFS& vfs, const Token& p1, const Token&) { vfs.cat(p1.str()); }},
+        {"truncate", [](VFS& vfs, const Token& p1, const Token& p2) { vfs.truncate(p1.str(), p2.str()); }},
+        {"cache", [](VFS& vfs, const Token& p1, const Token&) { vfs.cache(p1.str()); }},
+        {"df", [](VFS& vfs, const Token&, const Token&) { vfs.df(); }},
+        {"clear", [](VFS&, const Token&, const Token&) { cout.flush(); if (system("clear") != 0) { } }},
+    };
+
+    //the vector is filled before anything points into it
+    for (size_t i = 0; i < sizeof(table) / sizeof(table[0]); ++i) {
+        Command command = {table[i].name, hashName(table[i].name), table[i].run, Stats::instance().registerCommand(table[i].name)};
+        commands.push_back(command);
+    }
+    for (size_t i = 0; i < commands.size(); ++i) {
+        index.insert(&commands[i]);
+    }
+}
+
+//create a method that splits a line, looks the command up and runs it, then lets the VFS purge the bin
+bool CommandTable::execute(VFS& vfs, const char* line, size_t length) {
+    Token command, parameter1, parameter2;
+    splitCommand(line, length, command, parameter1, parameter2);
+    if (command.is("exit")) {
+        return false;
+    }
+
+    try
+    {
+        Command* found = index.find(command.data, command.length, hashBytes(command.data, command.length));
+        if (found != nullptr) {
+            VFS_TIME_COMMAND(found->stat);
+            found->run(vfs, parameter1, parameter2);
+        } else {
+            cout << command.str() << ": command not found" << endl;
+        }
+    }
+    catch(exception &e)
+    {
+        cout << "Exception: " << e.what() << endl;
+    }
+    //purge what is over the bin limits and free part of it before the next command
+    vfs.maintain();
+    return true;
+}
+
+const size_t BatchOutput::BLOCK;
+
+BatchOutput::BatchOutput(int fd) : block(new char[BLOCK]), fd(fd) {
+    setp(block, block + BLOCK);
+}
+
+BatchOutput::~BatchOutput() {
+    writeOut();
+    delete[] block;
+}
+
+//the stream writes into the block directly and calls this only when the block is full
+int BatchOutput::overflow(int c) {
+    writeOut();
+    if (c != EOF) {
+        *pptr() = static_cast<char>(c);
+        pbump(1);
+    }
+    return c == EOF ? 0 : c;
+}
+
+int BatchOutput::sync() {
+    return 0;//endl flushes, but the block is written only when it is full
+}
+
+//create a method that writes the gathered output with as few system calls as the kernel allows
+void BatchOutput::writeOut() {
+    size_t done = 0;
+    size_t length = pptr() - pbase();
+    while (done < length) {
+        ssize_t n = ::write(fd, block + done, length - done);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        done += n;
+    }
+    setp(block, block + BLOCK);
+}
+
+inline void runBatch(VFS& vfs, CommandTable& commands, const string& script, BatchOutput& output) {
+    LineReader reader(1 << 20);
+    if (!reader.open(script)) {
+        cerr << "Could not open the script '" << script << "'." << endl;
+        return;
+    }
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    uint64_t count = 0;
+    const char* line;
+    size_t length;
+    while (reader.next(line, length)) {
+        if (length == 0 || line[0] == '#') {//blank lines and comments
+            continue;
+        }
+        count++;
+        if (!commands.execute(vfs, line, length)) {
+            break;
+        }
+    }
+    output.writeOut();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    fprintf(stderr, "Ran %llu commands in %.3f s, %.0f commands/sec.\n", (unsigned long long)count, seconds, seconds > 0 ? count / seconds : 0.0);
+}
+
+#endif
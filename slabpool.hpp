@@ -0,0 +1,222 @@
+//============================================================================
+// Name         : slabpool.hpp
+// Author       : Aysa Binte masud
+// Version      : 01
+// Date Created : 17 October 2026
+// Date Modified: 17 October 2026
+// Description  : Slab arena with free-list recycling in C++
+//============================================================================
+//
+// Objects are carved out of large slabs that are aligned to their own size,
+// so the slab an object lives in is found by masking its address. A freed
+// slot is pushed on a free list and handed out again before the arena grows.
+// Pointers returned by create() stay valid until the object is destroyed.
+//
+#ifndef SLABPOOL_H
+#define SLABPOOL_H
+#include<cstdlib>
+#include<cstdint>
+#include<cstring>
+#include<new>
+#include<utility>
+#include<type_traits>
+#include "vector.hpp"
+using namespace std;
+
+template <typename T>
+class SlabPool
+{
+    private:
+        static const size_t SLAB_BYTES = 1 << 18;      //size (and alignment) of one slab
+
+        union Slot {                                    //a slot holds an object or a free-list link
+            typename aligned_storage<sizeof(T), alignof(T)>::type storage;
+            Slot *next;
+        };
+
+        struct Slab {                                   //header at the start of each slab
+            uint64_t live[(SLAB_BYTES / sizeof(Slot) + 63) / 64];  //bitmap of the slots holding an object
+            size_t used;                                //slots handed out from this slab so far
+            Slot *slots() { return reinterpret_cast<Slot*>(reinterpret_cast<char*>(this) + HEADER_BYTES); }
+        };
+
+        static const size_t HEADER_BYTES = (sizeof(Slab) + alignof(Slot) - 1) / alignof(Slot) * alignof(Slot);
+        static const size_t SLOTS_PER_SLAB = (SLAB_BYTES - HEADER_BYTES) / sizeof(Slot);
+
+        Vector<Slab*> slabs;            //all slabs, the last one may still have untouched slots
+        Slot *free_list;                //recycled slots
+        size_t live_count;              //objects currently alive
+        size_t free_count;              //slots on the free list
+        uint64_t created;               //objects created since the arena was made
+        uint64_t destroyed;             //objects destroyed since the arena was made
+
+        static Slab* slabOf(const void* ptr);           //the slab an object belongs to
+        Slot* grab();                                   //a slot from the free list or the last slab
+
+        SlabPool(const SlabPool&);
+        SlabPool& operator=(const SlabPool&);
+    public:
+        SlabPool();
+        ~SlabPool();
+        template <typename... Args>
+        T* create(Args&&... args);      //construct an object in the arena
+        void destroy(T* ptr);           //destruct an object and recycle its slot
+        void reset();                   //destroy every object and release all slabs
+        bool isLive(const T* ptr) const;//true if ptr, created by this arena, has not been destroyed
+
+        size_t slabCount() const;       //number of slabs
+        size_t liveCount() const;       //number of live objects
+        size_t freeCount() const;       //number of slots on the free list
+        size_t slotCount() const;       //total number of slots in all slabs
+        size_t bytesReserved() const;   //memory held by the arena
+        uint64_t createdCount() const;  //objects created so far
+        uint64_t destroyedCount() const;//objects destroyed so far
+};
+//================================================
+
+//constructor for an empty arena, slabs are allocated on demand
+template <typename T>
+SlabPool<T>::SlabPool() : slabs(0), free_list(nullptr), live_count(0), free_count(0), created(0), destroyed(0) {
+}
+
+//destructor for destroying the remaining objects and freeing the slabs
+template <typename T>
+SlabPool<T>::~SlabPool() {
+    reset();
+}
+
+template <typename T>
+typename SlabPool<T>::Slab* SlabPool<T>::slabOf(const void* ptr) {
+    return reinterpret_cast<Slab*>(reinterpret_cast<uintptr_t>(ptr) & ~(uintptr_t)(SLAB_BYTES - 1));
+}
+
+//take a recycled slot if there is one, otherwise the next untouched slot of the last slab
+template <typename T>
+typename SlabPool<T>::Slot* SlabPool<T>::grab() {
+    if (free_list != nullptr) {
+        Slot* slot = free_list;
+        free_list = slot->next;
+        free_count--;
+        return slot;
+    }
+
+    if (slabs.empty() || slabs[slabs.size() - 1]->used == SLOTS_PER_SLAB) {//allocate a new slab
+        void* memory = nullptr;
+        if (posix_memalign(&memory, SLAB_BYTES, SLAB_BYTES) != 0) {
+            throw bad_alloc();
+        }
+        Slab* slab = static_cast<Slab*>(memory);
+        memset(slab->live, 0, sizeof(slab->live));
+        slab->used = 0;
+        slabs.push_back(slab);
+    }
+
+    Slab* slab = slabs[slabs.size() - 1];
+    return slab->slots() + slab->used++;
+}
+
+template <typename T>
+template <typename... Args>
+T* SlabPool<T>::create(Args&&... args) {
+    Slot* slot = grab();
+    T* ptr = new (&slot->storage) T(std::forward<Args>(args)...);
+
+    Slab* slab = slabOf(slot);
+    size_t index = slot - slab->slots();
+    slab->live[index / 64] |= 1ULL << (index % 64);//mark the slot as live
+    live_count++;
+    created++;
+    return ptr;
+}
+
+template <typename T>
+void SlabPool<T>::destroy(T* ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+    ptr->~T();
+
+    Slot* slot = reinterpret_cast<Slot*>(ptr);
+    Slab* slab = slabOf(slot);
+    size_t index = slot - slab->slots();
+    slab->live[index / 64] &= ~(1ULL << (index % 64));
+
+    slot->next = free_list;//push the slot on the free list
+    free_list = slot;
+    free_count++;
+    live_count--;
+    destroyed++;
+}
+
+//release the whole arena one slab at a time; only live slots need their destructor run
+template <typename T>
+void SlabPool<T>::reset() {
+    for (int i = 0; i < slabs.size(); ++i) {
+        Slab* slab = slabs[i];
+        if (!is_trivially_destructible<T>::value) {
+            for (size_t w = 0; w * 64 < slab->used; ++w) {//scan the live bitmap a word at a time
+                for (uint64_t bits = slab->live[w]; bits != 0; bits &= bits - 1) {
+                    size_t index = w * 64 + __builtin_ctzll(bits);
+                    reinterpret_cast<T*>(&slab->slots()[index].storage)->~T();
+                }
+            }
+        }
+        free(slab);
+    }
+    destroyed += live_count;
+    while (!slabs.empty()) {
+        slabs.erase(slabs.size() - 1);
+    }
+    free_list = nullptr;
+    live_count = 0;
+    free_count = 0;
+}
+
+//create a method that checks the live bit of an object's slot; the slab stays allocated until reset
+template <typename T>
+bool SlabPool<T>::isLive(const T* ptr) const {
+    if (ptr == nullptr) {
+        return false;
+    }
+    const Slot* slot = reinterpret_cast<const Slot*>(ptr);
+    Slab* slab = slabOf(slot);
+    size_t index = slot - slab->slots();
+    return (slab->live[index / 64] >> (index % 64)) & 1;
+}
+
+template <typename T>
+size_t SlabPool<T>::slabCount() const {
+    return slabs.size();
+}
+
+template <typename T>
+size_t SlabPool<T>::liveCount() const {
+    return live_count;
+}
+
+template <typename T>
+size_t SlabPool<T>::freeCount() const {
+    return free_count;
+}
+
+template <typename T>
+size_t SlabPool<T>::slotCount() const {
+    return slabs.size() * SLOTS_PER_SLAB;
+}
+
+template <typename T>
+size_t SlabPool<T>::bytesReserved() const {
+    return slabs.size() * SLAB_BYTES;
+}
+
+template <typename T>
+uint64_t SlabPool<T>::createdCount() const {
+    return created;
+}
+
+template <typename T>
+uint64_t SlabPool<T>::destroyedCount() const {
+    return destroyed;
+}
+
+#endif
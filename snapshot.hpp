@@ -0,0 +1,429 @@
+//============================================================================
+// Name         : snapshot.hpp
+// Author       : Aysa Binte masud
+// Version      : 01
+// Date Created : 17 October 2026
+// Date Modified: 17 October 2026
+// Description  : Memory-mappable binary snapshot of the tree in C++
+//============================================================================
+//
+// A snapshot file is a header followed by the columns of an InodeTable,
+// each aligned to 8 bytes: parent, first child, next sibling and subtree
+// end offsets, type, size (the aggregate for folders), creation time, name
+// offsets and the string pool, then the offsets of the contents of each
+// Inode in a pool of file contents; a file whose size is larger than its
+// contents reads as zeros past them, and its contents are read from the
+// mapping until it is written. The items in the bin follow the tree as
+// subtrees of their own, with their numbers, deletion times and original
+// paths (in a second pool); an extra subtree numbered 0 is not a bin item
+// but a point-in-time view of the tree, whose path is /.snap/ and its name.
+// The header records the last journal record the snapshot contains. Opening
+// one only maps the file and checks the header; Inodes are created from it
+// one folder at a time, when the folder's children are first needed.
+// Every Inode created from the snapshot is added to the global name index,
+// and the lazy ones are remembered by entry so that a name found in the
+// mapping can be located under the Inode that stands for its subtree.
+//
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+#include<iostream>
+#include<cstdint>
+#include<cstring>
+#include<string>
+#include<vector>
+#include<unordered_map>
+#include<algorithm>
+#include<fcntl.h>
+#include<unistd.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
+#include "inode.hpp"
+#include "slabpool.hpp"
+#include "nameindex.hpp"
+#include "pattern.hpp"
+#include "listing.hpp"
+#include "filestore.hpp"
+using namespace std;
+
+const char SNAPSHOT_MAGIC[8] = {'V', 'F', 'S', 'S', 'N', 'A', 'P', 0};
+const uint32_t SNAPSHOT_VERSION = 4;
+
+//the columns of a snapshot, in file order
+enum {SEC_PARENT, SEC_FIRST_CHILD, SEC_NEXT_SIBLING, SEC_END, SEC_TYPE, SEC_SIZE, SEC_TIME, SEC_NAME_OFF, SEC_NAMES,
+      SEC_BIN, SEC_BIN_PATH_OFF, SEC_BIN_PATHS, SEC_BIN_ID, SEC_BIN_TIME, SEC_DATA_OFF, SEC_DATA, SECTIONS};
+const uint64_t SECTION_WIDTHS[SECTIONS] = {4, 4, 4, 4, 1, 8, 8, 4, 1, 4, 4, 1, 8, 8, 8, 1};
+
+//what a snapshot keeps of a bin item besides its subtree
+struct SnapshotBinItem
+{
+    uint64_t id;                    //number of the item
+    int64_t deleted;                //time of removal
+    string path;                    //original path
+};
+
+struct SnapshotHeader
+{
+    char magic[8];                  //SNAPSHOT_MAGIC
+    uint32_t version;               //SNAPSHOT_VERSION
+    uint32_t header_bytes;          //sizeof(SnapshotHeader) when written
+    uint64_t count;                 //number of Inodes
+    uint64_t names_bytes;           //size of the string pool
+    uint64_t bin_count;             //number of items in the bin
+    uint64_t bin_paths_bytes;       //size of the pool of bin paths
+    uint64_t bin_next_id;           //number the next bin item gets
+    uint64_t journal_sequence;      //last journal record included, 0 if none
+    uint64_t data_bytes;            //size of the pool of file contents
+    uint64_t offset[SECTIONS];      //file offset of each column
+};
+
+//number of elements in a column of a snapshot
+inline uint64_t sectionElements(const SnapshotHeader& h, int s) {
+    switch (s) {
+        case SEC_NAME_OFF:
+        case SEC_DATA_OFF: return h.count + 1;
+        case SEC_DATA: return h.data_bytes;
+        case SEC_NAMES: return h.names_bytes;
+        case SEC_BIN:
+        case SEC_BIN_ID:
+        case SEC_BIN_TIME: return h.bin_count;
+        case SEC_BIN_PATH_OFF: return h.bin_count + 1;
+        case SEC_BIN_PATHS: return h.bin_paths_bytes;
+        default: return h.count;
+    }
+}
+
+class MappedSnapshot : public ChildSource
+{
+    private:
+        void *base;                     //start of the mapping
+        size_t length;                  //length of the mapping
+        const SnapshotHeader *header;
+        const uint32_t *parent;
+        const uint32_t *first_child;
+        const uint32_t *next_sibling;
+        const uint32_t *end;
+        const uint8_t *type;
+        const uint64_t *size;
+        const int64_t *cr_time;
+        const uint32_t *name_off;
+        const char *names;
+        const uint32_t *bin;
+        const uint32_t *bin_path_off;
+        const char *bin_paths;
+        const uint64_t *bin_id;
+        const int64_t *bin_time;
+        const uint64_t *data_off;
+        const char *data;
+        SlabPool<Inode> *pool;          //where materialized Inodes are allocated
+        FileStore *files;               //where the contents of materialized files are held
+        NameIndex *name_index;          //where materialized Inodes are indexed
+        uint64_t expanded;              //number of folders materialized so far
+        unordered_multimap<uint32_t, Inode*> lazy_nodes;    //entry of every Inode whose children are still in the mapping, copies share it
+        vector<pair<uint64_t, uint32_t> > by_hash;      //(hash of the name, entry) sorted, built by the first lookup
+
+        Inode* createLazy(uint32_t i, Inode* parent);   //create the Inode of entry i, lazy if it has children
+        void unlink(Inode* node);                       //node no longer holds its entry
+
+        MappedSnapshot(const MappedSnapshot&);
+        MappedSnapshot& operator=(const MappedSnapshot&);
+    public:
+        static const uint32_t NONE = 0xFFFFFFFF;
+
+        MappedSnapshot(SlabPool<Inode>* pool, NameIndex* name_index, FileStore* files);
+        ~MappedSnapshot();
+        bool open(const string& filename, string& error);   //map a snapshot file and check its header
+        void close();
+        bool isOpen() const;
+        uint32_t count() const;
+        Inode* createRoot();                                //a lazy Inode for entry 0
+        uint32_t binCount() const;
+        Inode* createBinItem(uint32_t k);                   //a lazy Inode for the k-th oldest item of the bin
+        string binPath(uint32_t k) const;                   //original path of that item
+        uint64_t binId(uint32_t k) const;                   //its number
+        int64_t binDeleted(uint32_t k) const;               //its time of removal
+        uint64_t binNextId() const;                         //number the next bin item gets
+        uint64_t journalSequence() const;                   //last journal record contained in the snapshot
+        void expand(Inode* node);                           //create the children of a lazy Inode
+        void share(Inode* copy, Inode* original);           //copy holds the entry of original too
+        void list(uint32_t i, ostream& out) const;          //ls of entry i without materializing it
+        void findName(uint32_t i, const string& name, vector<uint32_t>& hits) const; //entries below i called name
+        string relativePath(uint32_t i, uint32_t ancestor) const;    //path of i below ancestor, starting with '/'
+        void lookupName(const string& name, vector<uint32_t>& hits);    //entries called name, through the hash column
+        void matchRange(uint32_t first, uint32_t last, const NamePattern& pattern, vector<uint32_t>& hits) const; //entries in [first, last) whose name matches
+        uint32_t subtreeEnd(uint32_t i) const;              //one past the last entry below i
+        void lazyHolders(uint32_t i, vector<pair<Inode*, uint32_t> >& holders) const;   //the lazy Inodes (and their entries) whose subtrees hold entry i
+        void forget(Inode* node);                           //a lazy Inode is being destroyed
+        uint64_t expandedCount() const;
+};
+//================================================
+
+const uint32_t MappedSnapshot::NONE;
+
+MappedSnapshot::MappedSnapshot(SlabPool<Inode>* pool, NameIndex* name_index, FileStore* files) : base(nullptr), length(0), header(nullptr), pool(pool), files(files), name_index(name_index), expanded(0) {
+}
+
+MappedSnapshot::~MappedSnapshot() {
+    close();
+}
+
+//create a method that maps the file; only the header is read, the pages of the columns are faulted in on use
+bool MappedSnapshot::open(const string& filename, string& error) {
+    close();
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = "could not open '" + filename + "'";
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(SnapshotHeader)) {
+        ::close(fd);
+        error = "'" + filename + "' is not a snapshot";
+        return false;
+    }
+    void* memory = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);//the mapping keeps the file open
+    if (memory == MAP_FAILED) {
+        error = "could not map '" + filename + "'";
+        return false;
+    }
+
+    const SnapshotHeader* h = static_cast<const SnapshotHeader*>(memory);
+    if (memcmp(h->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 || h->version != SNAPSHOT_VERSION || h->count == 0 || h->count >= NONE) {
+        munmap(memory, st.st_size);
+        error = "'" + filename + "' is not a version " + to_string(SNAPSHOT_VERSION) + " snapshot";
+        return false;
+    }
+
+    //every column has to lie inside the file and be aligned for its type
+    for (int s = 0; s < SECTIONS; ++s) {
+        uint64_t elements = sectionElements(*h, s);
+        if (h->bin_count >= h->count || h->offset[s] % 8 != 0 || h->offset[s] > (uint64_t)st.st_size
+            || elements * SECTION_WIDTHS[s] > st.st_size - h->offset[s]) {
+            munmap(memory, st.st_size);
+            error = "'" + filename + "' is truncated or corrupt";
+            return false;
+        }
+    }
+
+    const char* bytes = static_cast<const char*>(memory);
+    const uint32_t* bin_index = reinterpret_cast<const uint32_t*>(bytes + h->offset[SEC_BIN]);
+    const uint32_t* path_off = reinterpret_cast<const uint32_t*>(bytes + h->offset[SEC_BIN_PATH_OFF]);
+    for (uint64_t k = 0; k < h->bin_count; ++k) {
+        if (bin_index[k] == 0 || bin_index[k] >= h->count || path_off[k] > path_off[k + 1] || path_off[k + 1] > h->bin_paths_bytes) {
+            munmap(memory, st.st_size);
+            error = "'" + filename + "' has a corrupt bin";
+            return false;
+        }
+    }
+
+    base = memory;
+    length = st.st_size;
+    header = h;
+    parent = reinterpret_cast<const uint32_t*>(bytes + h->offset[SEC_PARENT]);
+    first_child = reinterpret_cast<const uint32_t*>(bytes + h->offset[SEC_FIRST_CHILD]);
+    next_sibling = reinterpret_cast<const uint32_t*>(bytes + h->offset[SEC_NEXT_SIBLING]);
+    end = reinterpret_cast<const uint32_t*>(bytes + h->offset[SEC_END]);
+    type = reinterpret_cast<const uint8_t*>(bytes + h->offset[SEC_TYPE]);
+    size = reinterpret_cast<const uint64_t*>(bytes + h->offset[SEC_SIZE]);
+    cr_time = reinterpret_cast<const int64_t*>(bytes + h->offset[SEC_TIME]);
+    name_off = reinterpret_cast<const uint32_t*>(bytes + h->offset[SEC_NAME_OFF]);
+    names = bytes + h->offset[SEC_NAMES];
+    bin = reinterpret_cast<const uint32_t*>(bytes + h->offset[SEC_BIN]);
+    bin_path_off = reinterpret_cast<const uint32_t*>(bytes + h->offset[SEC_BIN_PATH_OFF]);
+    bin_paths = bytes + h->offset[SEC_BIN_PATHS];
+    bin_id = reinterpret_cast<const uint64_t*>(bytes + h->offset[SEC_BIN_ID]);
+    bin_time = reinterpret_cast<const int64_t*>(bytes + h->offset[SEC_BIN_TIME]);
+    data_off = reinterpret_cast<const uint64_t*>(bytes + h->offset[SEC_DATA_OFF]);
+    data = bytes + h->offset[SEC_DATA];
+    expanded = 0;
+    return true;
+}
+
+//the Inodes created from the snapshot must be gone before it is closed
+void MappedSnapshot::close() {
+    if (base != nullptr) {
+        munmap(base, length);
+        base = nullptr;
+        header = nullptr;
+    }
+    lazy_nodes.clear();
+    by_hash.clear();
+}
+
+bool MappedSnapshot::isOpen() const {
+    return base != nullptr;
+}
+
+uint32_t MappedSnapshot::count() const {
+    return header != nullptr ? header->count : 0;
+}
+
+//create a method that creates and indexes the Inode of an entry, leaving its children in the mapping
+Inode* MappedSnapshot::createLazy(uint32_t i, Inode* parent) {
+    Inode* node = pool->create(string(names + name_off[i], name_off[i + 1] - name_off[i]), parent, type[i] != 0, size[i], cr_time[i]);
+    if (type[i] == Folder && first_child[i] != NONE) {
+        node->lazy = this;
+        node->lazy_index = i;
+        lazy_nodes.insert(make_pair(i, node));
+    }
+    //the contents stay in the mapping; offsets outside the pool are taken as none
+    if (type[i] == File && data_off[i] < data_off[i + 1] && data_off[i + 1] <= header->data_bytes) {
+        node->data = files->createMapped(data + data_off[i], data_off[i + 1] - data_off[i]);
+    }
+    return node;
+}
+
+Inode* MappedSnapshot::createRoot() {
+    return createLazy(0, nullptr);//the root is never a find result, so it is not indexed
+}
+
+uint32_t MappedSnapshot::binCount() const {
+    return header != nullptr ? header->bin_count : 0;
+}
+
+//create a method that creates a bin item the same way as the root, detached from the tree
+Inode* MappedSnapshot::createBinItem(uint32_t k) {
+    Inode* item = createLazy(bin[k], nullptr);
+    name_index->insert(item);
+    return item;
+}
+
+string MappedSnapshot::binPath(uint32_t k) const {
+    return string(bin_paths + bin_path_off[k], bin_path_off[k + 1] - bin_path_off[k]);
+}
+
+uint64_t MappedSnapshot::binId(uint32_t k) const {
+    return bin_id[k];
+}
+
+int64_t MappedSnapshot::binDeleted(uint32_t k) const {
+    return bin_time[k];
+}
+
+uint64_t MappedSnapshot::binNextId() const {
+    return header != nullptr ? header->bin_next_id : 1;
+}
+
+uint64_t MappedSnapshot::journalSequence() const {
+    return header != nullptr ? header->journal_sequence : 0;
+}
+
+//create a method that materializes the children of one folder, which stay lazy themselves
+void MappedSnapshot::expand(Inode* node) {
+    uint32_t n = count();
+    uint32_t steps = 0;//a corrupt sibling chain must not loop forever
+    unlink(node);
+    for (uint32_t c = first_child[node->lazy_index]; c < n && steps < n; c = next_sibling[c], ++steps) {
+        Inode* child = createLazy(c, node);
+        node->addChild(child);
+        name_index->insert(child);
+    }
+    expanded++;
+}
+
+//create a method that prints the children of an entry the way ls does, straight from the mapping
+void MappedSnapshot::list(uint32_t i, ostream& out) const {
+    uint32_t n = count();
+    uint32_t steps = 0;
+    ListWriter writer(out);
+    for (uint32_t c = first_child[i]; c < n && steps < n; c = next_sibling[c], ++steps) {
+        writer.entry(type[c] != 0, names + name_off[c], name_off[c + 1] - name_off[c], cr_time[c], size[c]);
+    }
+}
+
+//create a method that scans the name column over the subtree range of entry i
+void MappedSnapshot::findName(uint32_t i, const string& name, vector<uint32_t>& hits) const {
+    uint32_t last = min(end[i], count());
+    for (uint32_t j = i + 1; j < last; ++j) {
+        if (name_off[j + 1] - name_off[j] == name.size() && memcmp(names + name_off[j], name.data(), name.size()) == 0) {
+            hits.push_back(j);
+        }
+    }
+}
+
+//create a method that builds the path from an ancestor down to an entry by following the parent column
+string MappedSnapshot::relativePath(uint32_t i, uint32_t ancestor) const {
+    vector<uint32_t> chain;
+    for (uint32_t j = i; j != ancestor && j < count(); j = parent[j]) {
+        chain.push_back(j);
+    }
+    string result;
+    for (int k = chain.size() - 1; k >= 0; --k) {
+        result += '/';
+        result.append(names + name_off[chain[k]], name_off[chain[k] + 1] - name_off[chain[k]]);
+    }
+    return result;
+}
+
+//create a method that finds a name through a sorted column of name hashes, built the first time it is needed
+void MappedSnapshot::lookupName(const string& name, vector<uint32_t>& hits) {
+    if (by_hash.empty() && count() > 1) {
+        by_hash.reserve(count() - 1);
+        for (uint32_t j = 1; j < count(); ++j) {
+            by_hash.push_back(make_pair(hashBytes(names + name_off[j], name_off[j + 1] - name_off[j]), j));
+        }
+        sort(by_hash.begin(), by_hash.end());
+    }
+
+    uint64_t hash = hashName(name);
+    vector<pair<uint64_t, uint32_t> >::const_iterator it = lower_bound(by_hash.begin(), by_hash.end(), make_pair(hash, (uint32_t)0));
+    for (; it != by_hash.end() && it->first == hash; ++it) {
+        uint32_t j = it->second;
+        if (name_off[j + 1] - name_off[j] == name.size() && memcmp(names + name_off[j], name.data(), name.size()) == 0) {
+            hits.push_back(j);
+        }
+    }
+}
+
+//create a method that matches the names of a range of entries; it only reads the mapping, so threads can share it
+void MappedSnapshot::matchRange(uint32_t first, uint32_t last, const NamePattern& pattern, vector<uint32_t>& hits) const {
+    last = min(last, count());
+    for (uint32_t j = first; j < last; ++j) {
+        if (pattern.match(names + name_off[j], name_off[j + 1] - name_off[j])) {
+            hits.push_back(j);
+        }
+    }
+}
+
+uint32_t MappedSnapshot::subtreeEnd(uint32_t i) const {
+    return min(end[i], count());
+}
+
+//create a method that walks up the parent column collecting every lazy Inode of an ancestor entry; none if entry i is an Inode of its own (or was purged)
+void MappedSnapshot::lazyHolders(uint32_t i, vector<pair<Inode*, uint32_t> >& holders) const {
+    uint32_t steps = 0;
+    for (uint32_t j = parent[i]; j < count() && steps < count(); j = parent[j], ++steps) {
+        //an entry has one Inode in the tree, plus one for each copy made while it was lazy
+        pair<unordered_multimap<uint32_t, Inode*>::const_iterator, unordered_multimap<uint32_t, Inode*>::const_iterator> range = lazy_nodes.equal_range(j);
+        for (unordered_multimap<uint32_t, Inode*>::const_iterator it = range.first; it != range.second; ++it) {
+            holders.push_back(make_pair(it->second, j));
+        }
+    }
+}
+
+//the mapping never changes, so a copy of a lazy Inode can read the same entry
+void MappedSnapshot::share(Inode* copy, Inode* original) {
+    copy->lazy = this;
+    copy->lazy_index = original->lazy_index;
+    lazy_nodes.insert(make_pair(copy->lazy_index, copy));
+}
+
+void MappedSnapshot::unlink(Inode* node) {
+    pair<unordered_multimap<uint32_t, Inode*>::iterator, unordered_multimap<uint32_t, Inode*>::iterator> range = lazy_nodes.equal_range(node->lazy_index);
+    for (unordered_multimap<uint32_t, Inode*>::iterator it = range.first; it != range.second; ++it) {
+        if (it->second == node) {
+            lazy_nodes.erase(it);
+            return;
+        }
+    }
+}
+
+void MappedSnapshot::forget(Inode* node) {
+    unlink(node);
+}
+
+uint64_t MappedSnapshot::expandedCount() const {
+    return expanded;
+}
+
+#endif
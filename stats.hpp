@@ -0,0 +1,357 @@
+//============================================================================
+// Name         : stats.hpp
+// Author       : Aysa Binte masud
+// Version      : 01
+// Date Created : 17 October 2026
+// Date Modified: 17 October 2026
+// Description  : Per-thread counters and latency histograms of the VFS
+//============================================================================
+//
+// Every thread that counts gets a block of its own, so counting is a plain
+// load and store on memory no other thread writes: no lock and no atomic
+// read-modify-write. The blocks are kept in a list; the stats command adds
+// them up, and a block left by a thread that ended is reused by the next
+// one, so its counts are not lost. Latencies go into HDR-style histograms:
+// values below 16 ns have a bucket each, above that every power of two is
+// split into 16 buckets, so a percentile is within 1/16 of the true value.
+// Building with -DVFS_NO_STATS turns VFS_COUNT and VFS_TIME_COMMAND into
+// nothing.
+//
+#ifndef STATS_H
+#define STATS_H
+#include<iostream>
+#include<iomanip>
+#include<cstdint>
+#include<string>
+#include<vector>
+#include<mutex>
+#include<atomic>
+#include<chrono>
+#include<algorithm>
+using namespace std;
+
+//what is counted inside the VFS
+enum StatCounter
+{
+    S_PATHS,                //paths resolved by getNode
+    S_COMPONENTS,           //path components walked by getNode, without the cached prefix
+    S_CHILDREN,             //children scanned by ls, find, size and the purge
+    S_SIZE_STEPS,           //Inodes updated while propagating a size change
+    S_CREATED,              //Inodes created
+    S_FREED,                //Inodes freed by the purge
+    S_BIN_ADDED,            //items put in the bin
+    S_BIN_PURGED,           //items purged from the bin
+    S_BYTES_WRITTEN,        //bytes written to files by write and append
+    S_BYTES_READ,           //bytes of files read by cat
+    S_COUNTERS
+};
+
+//the totals of every thread's block, as the stats command shows them
+struct StatTotals
+{
+    static const unsigned COMMANDS = 32;
+    static const unsigned BUCKETS = 16 + 36 * 16;   //exact below 16 ns, then 16 per power of two up to 2^40 ns
+
+    uint64_t counters[S_COUNTERS];
+    uint64_t count[COMMANDS];
+    uint64_t total_ns[COMMANDS];
+    uint64_t max_ns[COMMANDS];
+    vector<uint64_t> buckets;       //COMMANDS rows of BUCKETS
+
+    StatTotals();
+    uint64_t percentile(unsigned command, double p) const;  //the latency below which a share p of the calls fell, in ns
+};
+
+class Stats
+{
+    private:
+        struct Block
+        {
+            atomic<uint64_t> counters[S_COUNTERS];
+            atomic<uint64_t> count[StatTotals::COMMANDS];
+            atomic<uint64_t> total_ns[StatTotals::COMMANDS];
+            atomic<uint64_t> max_ns[StatTotals::COMMANDS];
+            atomic<uint64_t>* buckets;  //COMMANDS rows of BUCKETS, allocated by the first timed command
+            bool in_use;                //a thread owns the block
+            Block* next;
+        };
+
+        //the block of the current thread, given back when the thread ends
+        struct Handle
+        {
+            Block* block;
+            Handle();
+            ~Handle();
+        };
+
+        mutex lock;                     //guards the list, the names and the buckets being allocated
+        Block* blocks;
+        vector<string> names;           //command of each histogram
+
+        Stats();
+        Stats(const Stats&);
+        Stats& operator=(const Stats&);
+        Block* acquire();
+        void release(Block* block);
+        static Block& local();
+        static void add(atomic<uint64_t>& value, uint64_t n);   //only the owning thread writes a block
+    public:
+        static Stats& instance();
+        static unsigned bucketOf(uint64_t ns);
+        static uint64_t bucketValue(unsigned bucket);           //the middle of a bucket
+        static void count(StatCounter counter, uint64_t n);
+        static void record(unsigned command, uint64_t ns);
+        static const char* counterName(StatCounter counter);
+        unsigned registerCommand(const string& name);           //the histogram of a command, COMMANDS if there is none left
+        void totals(StatTotals& out);
+        void reset();
+        void print(ostream& out, const StatTotals& totals);
+        void printJson(ostream& out, const StatTotals& totals);  //the commands and the counters as members of a JSON object
+};
+
+//times a command from its construction to the end of its scope
+class CommandTimer
+{
+    private:
+        unsigned command;
+        chrono::steady_clock::time_point start;
+    public:
+        explicit CommandTimer(unsigned command) : command(command), start(chrono::steady_clock::now()) { }
+        ~CommandTimer() { Stats::record(command, chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count()); }
+};
+
+#ifndef VFS_NO_STATS
+#define VFS_COUNT(counter, n) Stats::count(counter, n)
+#define VFS_TIME_COMMAND(command) CommandTimer command_timer(command)
+#else
+#define VFS_COUNT(counter, n) ((void)0)
+#define VFS_TIME_COMMAND(command) ((void)0)
+#endif
+//================================================
+
+const unsigned StatTotals::COMMANDS;
+const unsigned StatTotals::BUCKETS;
+
+StatTotals::StatTotals() : buckets(COMMANDS * BUCKETS, 0) {
+    fill(counters, counters + S_COUNTERS, 0);
+    fill(count, count + COMMANDS, 0);
+    fill(total_ns, total_ns + COMMANDS, 0);
+    fill(max_ns, max_ns + COMMANDS, 0);
+}
+
+//create a method that walks the histogram of a command up to the bucket holding the wanted share of the calls
+uint64_t StatTotals::percentile(unsigned command, double p) const {
+    uint64_t wanted = static_cast<uint64_t>(p * count[command] + 0.5);
+    uint64_t seen = 0;
+    for (unsigned b = 0; b < BUCKETS; ++b) {
+        seen += buckets[command * BUCKETS + b];
+        if (seen >= max<uint64_t>(wanted, 1)) {
+            return min(Stats::bucketValue(b), max_ns[command]);
+        }
+    }
+    return max_ns[command];
+}
+
+Stats::Stats() : blocks(nullptr) {
+}
+
+Stats& Stats::instance() {
+    static Stats stats;
+    return stats;
+}
+
+Stats::Handle::Handle() : block(Stats::instance().acquire()) {
+}
+
+Stats::Handle::~Handle() {
+    Stats::instance().release(block);
+}
+
+//create a method that hands a thread a free block, or a new one
+Stats::Block* Stats::acquire() {
+    lock_guard<mutex> guard(lock);
+    for (Block* block = blocks; block != nullptr; block = block->next) {
+        if (!block->in_use) {
+            block->in_use = true;
+            return block;
+        }
+    }
+    Block* block = new Block();
+    for (unsigned i = 0; i < S_COUNTERS; ++i) {
+        block->counters[i] = 0;
+    }
+    for (unsigned i = 0; i < StatTotals::COMMANDS; ++i) {
+        block->count[i] = block->total_ns[i] = block->max_ns[i] = 0;
+    }
+    block->buckets = nullptr;
+    block->in_use = true;
+    block->next = blocks;
+    blocks = block;
+    return block;
+}
+
+void Stats::release(Block* block) {
+    lock_guard<mutex> guard(lock);
+    block->in_use = false;
+}
+
+Stats::Block& Stats::local() {
+    static thread_local Handle handle;
+    return *handle.block;
+}
+
+void Stats::add(atomic<uint64_t>& value, uint64_t n) {
+    value.store(value.load(memory_order_relaxed) + n, memory_order_relaxed);
+}
+
+//create a method that maps a latency to its bucket: the power of two and the next 4 bits below it
+unsigned Stats::bucketOf(uint64_t ns) {
+    if (ns < 16) {
+        return static_cast<unsigned>(ns);
+    }
+    unsigned exponent = 63 - __builtin_clzll(ns);
+    if (exponent > 39) {
+        return StatTotals::BUCKETS - 1;
+    }
+    return (exponent - 3) * 16 + static_cast<unsigned>((ns >> (exponent - 4)) - 16);
+}
+
+uint64_t Stats::bucketValue(unsigned bucket) {
+    if (bucket < 16) {
+        return bucket;
+    }
+    unsigned exponent = bucket / 16 + 3;
+    uint64_t low = static_cast<uint64_t>(16 + bucket % 16) << (exponent - 4);
+    return low + (1ULL << (exponent - 4)) / 2;
+}
+
+void Stats::count(StatCounter counter, uint64_t n) {
+    add(local().counters[counter], n);
+}
+
+//create a method that adds one latency to the current thread's histogram of a command
+void Stats::record(unsigned command, uint64_t ns) {
+    if (command >= StatTotals::COMMANDS) {
+        return;
+    }
+    Block& block = local();
+    if (block.buckets == nullptr) {
+        atomic<uint64_t>* buckets = new atomic<uint64_t>[StatTotals::COMMANDS * StatTotals::BUCKETS];
+        for (unsigned i = 0; i < StatTotals::COMMANDS * StatTotals::BUCKETS; ++i) {
+            buckets[i] = 0;
+        }
+        lock_guard<mutex> guard(instance().lock);//totals reads the pointer under the lock
+        block.buckets = buckets;
+    }
+    add(block.count[command], 1);
+    add(block.total_ns[command], ns);
+    if (ns > block.max_ns[command].load(memory_order_relaxed)) {
+        block.max_ns[command].store(ns, memory_order_relaxed);
+    }
+    add(block.buckets[command * StatTotals::BUCKETS + bucketOf(ns)], 1);
+}
+
+const char* Stats::counterName(StatCounter counter) {
+    static const char* names[S_COUNTERS] = {"paths_resolved", "path_components", "children_scanned", "size_steps",
+        "inodes_created", "inodes_freed", "bin_added", "bin_purged", "bytes_written", "bytes_read"};
+    return names[counter];
+}
+
+unsigned Stats::registerCommand(const string& name) {
+    lock_guard<mutex> guard(lock);
+    for (unsigned i = 0; i < names.size(); ++i) {
+        if (names[i] == name) {
+            return i;
+        }
+    }
+    if (names.size() == StatTotals::COMMANDS) {
+        return StatTotals::COMMANDS;
+    }
+    names.push_back(name);
+    return names.size() - 1;
+}
+
+//create a method that adds up the blocks of every thread, the ones that ended included
+void Stats::totals(StatTotals& out) {
+    lock_guard<mutex> guard(lock);
+    for (Block* block = blocks; block != nullptr; block = block->next) {
+        for (unsigned i = 0; i < S_COUNTERS; ++i) {
+            out.counters[i] += block->counters[i].load(memory_order_relaxed);
+        }
+        for (unsigned c = 0; c < StatTotals::COMMANDS; ++c) {
+            out.count[c] += block->count[c].load(memory_order_relaxed);
+            out.total_ns[c] += block->total_ns[c].load(memory_order_relaxed);
+            out.max_ns[c] = max(out.max_ns[c], block->max_ns[c].load(memory_order_relaxed));
+        }
+        if (block->buckets != nullptr) {
+            for (unsigned i = 0; i < StatTotals::COMMANDS * StatTotals::BUCKETS; ++i) {
+                out.buckets[i] += block->buckets[i].load(memory_order_relaxed);
+            }
+        }
+    }
+}
+
+//a reset races with the threads counting at that moment, which may keep a count from before it
+void Stats::reset() {
+    lock_guard<mutex> guard(lock);
+    for (Block* block = blocks; block != nullptr; block = block->next) {
+        for (unsigned i = 0; i < S_COUNTERS; ++i) {
+            block->counters[i].store(0, memory_order_relaxed);
+        }
+        for (unsigned c = 0; c < StatTotals::COMMANDS; ++c) {
+            block->count[c].store(0, memory_order_relaxed);
+            block->total_ns[c].store(0, memory_order_relaxed);
+            block->max_ns[c].store(0, memory_order_relaxed);
+        }
+        if (block->buckets != nullptr) {
+            for (unsigned i = 0; i < StatTotals::COMMANDS * StatTotals::BUCKETS; ++i) {
+                block->buckets[i].store(0, memory_order_relaxed);
+            }
+        }
+    }
+}
+
+//create a method that prints a line per command that ran, with its latencies in microseconds, and then the counters
+void Stats::print(ostream& out, const StatTotals& totals) {
+    lock_guard<mutex> guard(lock);
+    out << left << setw(12) << "command" << right << setw(10) << "count" << setw(12) << "mean us" << setw(12) << "p50 us"
+        << setw(12) << "p90 us" << setw(12) << "p99 us" << setw(12) << "max us" << endl;
+    out << fixed << setprecision(1);
+    for (unsigned c = 0; c < names.size(); ++c) {
+        if (totals.count[c] == 0) {
+            continue;
+        }
+        out << left << setw(12) << names[c] << right << setw(10) << totals.count[c]
+            << setw(12) << totals.total_ns[c] / 1000.0 / totals.count[c]
+            << setw(12) << totals.percentile(c, 0.5) / 1000.0 << setw(12) << totals.percentile(c, 0.9) / 1000.0
+            << setw(12) << totals.percentile(c, 0.99) / 1000.0 << setw(12) << totals.max_ns[c] / 1000.0 << endl;
+    }
+    out.unsetf(ios::fixed);
+    out << setprecision(6);
+    for (unsigned i = 0; i < S_COUNTERS; ++i) {
+        out << left << setw(18) << counterName(static_cast<StatCounter>(i)) << right << ": " << totals.counters[i] << endl;
+    }
+}
+
+void Stats::printJson(ostream& out, const StatTotals& totals) {
+    lock_guard<mutex> guard(lock);
+    out << "\"commands\": {";
+    bool first = true;
+    for (unsigned c = 0; c < names.size(); ++c) {
+        if (totals.count[c] == 0) {
+            continue;
+        }
+        out << (first ? "" : ", ") << "\"" << names[c] << "\": {\"count\": " << totals.count[c]
+            << ", \"mean_ns\": " << totals.total_ns[c] / totals.count[c] << ", \"p50_ns\": " << totals.percentile(c, 0.5)
+            << ", \"p90_ns\": " << totals.percentile(c, 0.9) << ", \"p99_ns\": " << totals.percentile(c, 0.99)
+            << ", \"max_ns\": " << totals.max_ns[c] << "}";
+        first = false;
+    }
+    out << "}, \"counters\": {";
+    for (unsigned i = 0; i < S_COUNTERS; ++i) {
+        out << (i == 0 ? "" : ", ") << "\"" << counterName(static_cast<StatCounter>(i)) << "\": " << totals.counters[i];
+    }
+    out << "}";
+}
+
+#endif
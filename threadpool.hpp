@@ -0,0 +1,155 @@
+//============================================================================
+// Name         : threadpool.hpp
+// Author       : Aysa Binte masud
+// Version      : 01
+// Date Created : 17 October 2026
+// Date Modified: 17 October 2026
+// Description  : Work-stealing thread pool in C++
+//============================================================================
+//
+// Every worker owns a deque of tasks. It pushes and pops the tasks it
+// creates at the back, so it keeps working depth-first on what is hot in its
+// cache, and an idle worker steals from the front of another worker's deque,
+// where the oldest (and usually largest) tasks are. run() returns when no
+// task is queued or running any more.
+//
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+#include<atomic>
+#include<deque>
+#include<mutex>
+#include<thread>
+#include<vector>
+using namespace std;
+
+template <typename Task>
+class WorkStealingPool
+{
+    private:
+        struct TaskDeque
+        {
+            mutex lock;
+            deque<Task> tasks;
+        };
+
+        vector<TaskDeque*> deques;      //one per worker
+        atomic<size_t> pending;         //tasks queued or being processed
+        atomic<uint64_t> steals;        //tasks taken from another worker
+
+        bool popLocal(unsigned worker, Task& task);
+        bool steal(unsigned worker, Task& task);
+        template <typename F>
+        void work(unsigned worker, F& process);
+
+        WorkStealingPool(const WorkStealingPool&);
+        WorkStealingPool& operator=(const WorkStealingPool&);
+    public:
+        WorkStealingPool(unsigned threads);             //0 means one per hardware thread
+        ~WorkStealingPool();
+        unsigned size() const;                          //number of workers
+        void push(unsigned worker, const Task& task);   //queue a task on a worker's deque
+        size_t queued(unsigned worker);                 //tasks waiting on a worker's deque
+        template <typename F>
+        void run(F process);                            //process(task, worker) every task until none is left
+        uint64_t stealCount() const;
+};
+//================================================
+
+template <typename Task>
+WorkStealingPool<Task>::WorkStealingPool(unsigned threads) : pending(0), steals(0) {
+    if (threads == 0) {
+        threads = max(1u, thread::hardware_concurrency());
+    }
+    for (unsigned i = 0; i < threads; ++i) {
+        deques.push_back(new TaskDeque());
+    }
+}
+
+template <typename Task>
+WorkStealingPool<Task>::~WorkStealingPool() {
+    for (size_t i = 0; i < deques.size(); ++i) {
+        delete deques[i];
+    }
+}
+
+template <typename Task>
+unsigned WorkStealingPool<Task>::size() const {
+    return deques.size();
+}
+
+template <typename Task>
+void WorkStealingPool<Task>::push(unsigned worker, const Task& task) {
+    pending++;//counted before it is visible, so run() cannot end while it is queued
+    lock_guard<mutex> guard(deques[worker]->lock);
+    deques[worker]->tasks.push_back(task);
+}
+
+template <typename Task>
+size_t WorkStealingPool<Task>::queued(unsigned worker) {
+    lock_guard<mutex> guard(deques[worker]->lock);
+    return deques[worker]->tasks.size();
+}
+
+template <typename Task>
+bool WorkStealingPool<Task>::popLocal(unsigned worker, Task& task) {
+    lock_guard<mutex> guard(deques[worker]->lock);
+    if (deques[worker]->tasks.empty()) {
+        return false;
+    }
+    task = deques[worker]->tasks.back();
+    deques[worker]->tasks.pop_back();
+    return true;
+}
+
+//create a method that tries the other workers in turn, starting with the next one, and takes their oldest task
+template <typename Task>
+bool WorkStealingPool<Task>::steal(unsigned worker, Task& task) {
+    for (size_t k = 1; k < deques.size(); ++k) {
+        TaskDeque* victim = deques[(worker + k) % deques.size()];
+        lock_guard<mutex> guard(victim->lock);
+        if (!victim->tasks.empty()) {
+            task = victim->tasks.front();
+            victim->tasks.pop_front();
+            steals++;
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename Task>
+template <typename F>
+void WorkStealingPool<Task>::work(unsigned worker, F& process) {
+    Task task;
+    while (true) {
+        if (popLocal(worker, task) || steal(worker, task)) {
+            process(task, worker);
+            pending--;
+        } else if (pending == 0) {
+            return;
+        } else {
+            this_thread::yield();//another worker is still producing tasks
+        }
+    }
+}
+
+//create a method that runs the workers on new threads, the calling thread being worker 0, until every task is done
+template <typename Task>
+template <typename F>
+void WorkStealingPool<Task>::run(F process) {
+    vector<thread> threads;
+    for (unsigned i = 1; i < deques.size(); ++i) {
+        threads.push_back(thread([this, i, &process]() { work(i, process); }));
+    }
+    work(0, process);
+    for (size_t i = 0; i < threads.size(); ++i) {
+        threads[i].join();
+    }
+}
+
+template <typename Task>
+uint64_t WorkStealingPool<Task>::stealCount() const {
+    return steals;
+}
+
+#endif
@@ -0,0 +1,257 @@
+//============================================================================
+// Name         : trash.hpp
+// Author       : Aysa Binte masud
+// Version      : 01
+// Date Created : 17 October 2026
+// Date Modified: 17 October 2026
+// Description  : Indexed recycle bin in C++
+//============================================================================
+//
+// Every removed subtree becomes an item with a number, the time it was
+// removed and a handle to its parent: the parent's pointer and Inode
+// number. While the parent stays where it was, the original path is the
+// parent's path and the item's name, built only when it is printed or
+// saved, and the item is found by folder and name; once the parent is
+// moved or removed (VFS::freezePaths) the path is written into the item and
+// it is found by path. Items are linked oldest to newest, so the list is
+// also the index by deletion time, and they are found by number through a
+// hash map. The bin has no fixed capacity; VFS purges it by total size and
+// age, a bounded number of Inodes per command.
+//
+#ifndef TRASH_H
+#define TRASH_H
+#include<cstdint>
+#include<string>
+#include<unordered_map>
+#include<vector>
+#include<algorithm>
+#include "inode.hpp"
+#include "hash.hpp"
+using namespace std;
+
+struct TrashItem
+{
+    uint64_t id;            //number of the item, shown by showbin
+    Inode* node;            //the removed subtree
+    Inode* parent;          //handle of the folder it was removed from, nullptr if unknown
+    uint64_t parent_ino;    //Inode number of that folder, checked before the handle is used
+    string path;            //original path, empty while it is the parent's path and the name of node
+    int64_t deleted;        //time of removal in seconds since the epoch
+    TrashItem *older, *newer;   //neighbours in the deletion time order
+    TrashItem *prev_held, *next_held;   //neighbours among the items whose path is read through the same parent
+};
+
+class Trash
+{
+    private:
+        unordered_map<uint64_t, TrashItem*> by_id;
+        unordered_multimap<string, TrashItem*> by_path;     //the items whose path is written
+        unordered_multimap<uint64_t, TrashItem*> by_name;   //the others by parent and name (handleKey)
+        unordered_map<Inode*, TrashItem*> by_parent;        //and the first of them for each parent
+        TrashItem *oldest_item, *newest_item;
+        uint64_t next_id;               //number of the next item
+        uint64_t total_bytes;           //size of all the items
+
+        static uint64_t handleKey(uint64_t parent_ino, const string& name);
+        void unindex(TrashItem* item);
+
+        Trash(const Trash&);
+        Trash& operator=(const Trash&);
+    public:
+        Trash();
+        ~Trash();
+        TrashItem* add(Inode* node, Inode* parent, const string& path, int64_t deleted, uint64_t id = 0);  //the newest item, numbered id or the next number; an empty path is read through parent
+        TrashItem* find(uint64_t id) const;                 //nullptr if there is no such item
+        TrashItem* findPath(const string& path) const;      //the newest item whose path is written as path
+        TrashItem* findIn(Inode* parent, const string& name) const;    //the newest item named name whose path is read through parent
+        void heldBy(Inode* parent, vector<TrashItem*>& items) const;   //the items whose path is read through parent
+        void freeze(TrashItem* item, const string& path);   //write the path of an item, before its parent moves
+        bool hasWritten() const;                            //true if some item has its path written
+        TrashItem* oldest() const;
+        TrashItem* newest() const;
+        Inode* remove(TrashItem* item);                     //drop an item, returning its subtree
+        void clear();                                       //drop every item; the subtrees are the caller's
+        size_t size() const;
+        bool isEmpty() const;
+        uint64_t bytes() const;
+        uint64_t nextId() const;
+        void setNextId(uint64_t id);                        //continue the numbering of a saved bin
+};
+//================================================
+
+Trash::Trash() : oldest_item(nullptr), newest_item(nullptr), next_id(1), total_bytes(0) {
+}
+
+Trash::~Trash() {
+    clear();
+}
+
+uint64_t Trash::handleKey(uint64_t parent_ino, const string& name) {
+    return hashFinalize(parent_ino * 0x9E3779B97F4A7C15ULL ^ hashName(name));
+}
+
+//create a method that appends an item at the newest end and indexes it by number, and by path or by parent and name
+TrashItem* Trash::add(Inode* node, Inode* parent, const string& path, int64_t deleted, uint64_t id) {
+    TrashItem* item = new TrashItem();
+    item->id = id != 0 ? id : next_id;
+    next_id = max(next_id, item->id + 1);
+    item->node = node;
+    item->parent = parent;
+    item->parent_ino = parent != nullptr ? parent->getIno() : 0;
+    item->path = path;
+    item->deleted = deleted;
+    item->older = newest_item;
+    item->newer = nullptr;
+    (newest_item != nullptr ? newest_item->newer : oldest_item) = item;
+    newest_item = item;
+
+    by_id[item->id] = item;
+    if (!path.empty()) {
+        by_path.insert(make_pair(path, item));
+    } else {
+        by_name.insert(make_pair(handleKey(item->parent_ino, node->getName()), item));
+        TrashItem*& first = by_parent[parent];
+        item->prev_held = nullptr;
+        item->next_held = first;
+        if (first != nullptr) {
+            first->prev_held = item;
+        }
+        first = item;
+    }
+    total_bytes += node->getSize();
+    return item;
+}
+
+TrashItem* Trash::find(uint64_t id) const {
+    unordered_map<uint64_t, TrashItem*>::const_iterator it = by_id.find(id);
+    return it != by_id.end() ? it->second : nullptr;
+}
+
+//create a method that picks the most recently removed of the items with the same path
+TrashItem* Trash::findPath(const string& path) const {
+    TrashItem* found = nullptr;
+    pair<unordered_multimap<string, TrashItem*>::const_iterator, unordered_multimap<string, TrashItem*>::const_iterator> range = by_path.equal_range(path);
+    for (unordered_multimap<string, TrashItem*>::const_iterator it = range.first; it != range.second; ++it) {
+        if (found == nullptr || it->second->id > found->id) {
+            found = it->second;
+        }
+    }
+    return found;
+}
+
+//create a method that picks the most recently removed of the items with the same parent and name
+TrashItem* Trash::findIn(Inode* parent, const string& name) const {
+    TrashItem* found = nullptr;
+    pair<unordered_multimap<uint64_t, TrashItem*>::const_iterator, unordered_multimap<uint64_t, TrashItem*>::const_iterator> range = by_name.equal_range(handleKey(parent->getIno(), name));
+    for (unordered_multimap<uint64_t, TrashItem*>::const_iterator it = range.first; it != range.second; ++it) {
+        TrashItem* item = it->second;
+        if (item->parent == parent && item->node->getName() == name && (found == nullptr || item->id > found->id)) {
+            found = item;
+        }
+    }
+    return found;
+}
+
+void Trash::heldBy(Inode* parent, vector<TrashItem*>& items) const {
+    unordered_map<Inode*, TrashItem*>::const_iterator it = by_parent.find(parent);
+    for (TrashItem* item = it != by_parent.end() ? it->second : nullptr; item != nullptr; item = item->next_held) {
+        items.push_back(item);
+    }
+}
+
+void Trash::freeze(TrashItem* item, const string& path) {
+    unindex(item);
+    item->path = path;
+    by_path.insert(make_pair(path, item));
+}
+
+bool Trash::hasWritten() const {
+    return !by_path.empty();
+}
+
+TrashItem* Trash::oldest() const {
+    return oldest_item;
+}
+
+TrashItem* Trash::newest() const {
+    return newest_item;
+}
+
+//create a method that takes an item out of the index by path, or out of those by parent and name and its parent's list
+void Trash::unindex(TrashItem* item) {
+    if (!item->path.empty()) {
+        pair<unordered_multimap<string, TrashItem*>::iterator, unordered_multimap<string, TrashItem*>::iterator> range = by_path.equal_range(item->path);
+        for (unordered_multimap<string, TrashItem*>::iterator it = range.first; it != range.second; ++it) {
+            if (it->second == item) {
+                by_path.erase(it);
+                break;
+            }
+        }
+        return;
+    }
+    pair<unordered_multimap<uint64_t, TrashItem*>::iterator, unordered_multimap<uint64_t, TrashItem*>::iterator> names = by_name.equal_range(handleKey(item->parent_ino, item->node->getName()));
+    for (unordered_multimap<uint64_t, TrashItem*>::iterator it = names.first; it != names.second; ++it) {
+        if (it->second == item) {
+            by_name.erase(it);
+            break;
+        }
+    }
+    if (item->next_held != nullptr) {
+        item->next_held->prev_held = item->prev_held;
+    }
+    if (item->prev_held != nullptr) {
+        item->prev_held->next_held = item->next_held;
+    } else if (item->next_held != nullptr) {
+        by_parent[item->parent] = item->next_held;
+    } else {
+        by_parent.erase(item->parent);
+    }
+}
+
+//create a method that unlinks an item from the list and its indexes
+Inode* Trash::remove(TrashItem* item) {
+    (item->older != nullptr ? item->older->newer : oldest_item) = item->newer;
+    (item->newer != nullptr ? item->newer->older : newest_item) = item->older;
+    by_id.erase(item->id);
+    unindex(item);
+    total_bytes -= item->node->getSize();
+    Inode* node = item->node;
+    delete item;
+    return node;
+}
+
+void Trash::clear() {
+    while (oldest_item != nullptr) {
+        TrashItem* next = oldest_item->newer;
+        delete oldest_item;
+        oldest_item = next;
+    }
+    newest_item = nullptr;
+    by_id.clear();
+    by_path.clear();
+    by_name.clear();
+    by_parent.clear();
+    total_bytes = 0;
+}
+
+size_t Trash::size() const {
+    return by_id.size();
+}
+
+bool Trash::isEmpty() const {
+    return oldest_item == nullptr;
+}
+
+uint64_t Trash::bytes() const {
+    return total_bytes;
+}
+
+uint64_t Trash::nextId() const {
+    return next_id;
+}
+
+void Trash::setNextId(uint64_t id) {
+    next_id = id;
+}
+
+#endif
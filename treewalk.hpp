@@ -0,0 +1,105 @@
+//============================================================================
+// Name         : treewalk.hpp
+// Author       : Aysa Binte masud
+// Version      : 01
+// Date Created : 17 October 2026
+// Date Modified: 17 October 2026
+// Description  : Depth-first walk of a subtree without recursion in C++
+//============================================================================
+//
+// walkTree visits a subtree in the order ls and find print it, keeping one
+// frame per open folder (the folder, its children and the next position)
+// in a vector instead of on the call stack, so a chain of a million folders
+// needs a million small frames on the heap and no stack. The caller's
+// enter is called on an Inode before its children (pre-order) and decides
+// which children are walked: those of the Inode, of what a copy copies, or
+// none for a file or a folder still in a snapshot. leave is called after
+// them (post-order), which is where a path buffer is cut back. While one
+// child is visited the next sibling is prefetched, so the cache miss on a
+// scattered Inode overlaps with the work on the one before it.
+//
+#ifndef TREEWALK_H
+#define TREEWALK_H
+#include<vector>
+#include "inode.hpp"
+#include "vector.hpp"
+using namespace std;
+
+//a folder whose children are being walked
+struct WalkFrame
+{
+    Inode* node;
+    Inode* const* next;             //the next child to visit, in what enter returned for it
+    Inode* const* end;
+};
+
+const int PREFETCH_AHEAD = 4;       //how many siblings ahead of the one visited are prefetched
+
+//bring an Inode into the cache ahead of its visit
+inline void prefetchInode(const Inode* node) {
+#if defined(__GNUC__)
+    __builtin_prefetch(node);
+#else
+    (void)node;
+#endif
+}
+
+//the first children of a folder that is opened, the rest are prefetched as far ahead while it is walked
+inline void prefetchChildren(Vector<Inode*>& children) {
+    for (int i = 0; i < PREFETCH_AHEAD && i < children.size(); ++i) {
+        prefetchInode(children[i]);
+    }
+}
+
+//walk the subtree of top: enter(node) returns the children to walk or nullptr, leave(node) follows them
+template <typename Enter, typename Leave>
+void walkTree(Inode* top, Enter enter, Leave leave);
+
+//the same without a post-order visit
+template <typename Enter>
+void walkTree(Inode* top, Enter enter);
+//================================================
+
+//create a function that walks with an explicit stack of frames; a node without children to walk gets no frame
+template <typename Enter, typename Leave>
+void walkTree(Inode* top, Enter enter, Leave leave) {
+    vector<WalkFrame> stack;
+    Vector<Inode*>* children = enter(top);
+    if (children == nullptr || children->size() == 0) {
+        leave(top);
+        return;
+    }
+    WalkFrame first = {top, &(*children)[0], &(*children)[0] + children->size()};
+    stack.push_back(first);
+    prefetchChildren(*children);
+
+    while (!stack.empty()) {
+        WalkFrame& frame = stack.back();
+        if (frame.next == frame.end) {//every child was visited
+            Inode* node = frame.node;
+            stack.pop_back();
+            leave(node);
+            continue;
+        }
+        Inode* child = *frame.next++;
+        if (frame.end - frame.next >= PREFETCH_AHEAD) {
+            prefetchInode(frame.next[PREFETCH_AHEAD - 1]);
+        }
+
+        children = enter(child);//may grow the stack, so frame is not used after this
+        if (children == nullptr || children->size() == 0) {
+            leave(child);
+            continue;
+        }
+        WalkFrame open = {child, &(*children)[0], &(*children)[0] + children->size()};
+        stack.push_back(open);
+        prefetchChildren(*children);
+    }
+}
+
+template <typename Enter>
+void walkTree(Inode* top, Enter enter) {
+    walkTree(top, enter, [](Inode*) { });
+}
+
+#endif
@@ -3,80 +3,229 @@
 // Author       : Aysa Binte masud
 // Version      : 01
 // Date Created : 5 November 2023
-// Date Modified: 12 November 2023
+// Date Modified: 17 October 2026
 // Description  : Vector implmentation in C++
 //============================================================================
+//
+// The first N elements live in a buffer inside the Vector itself, so a small
+// vector (most folders have fewer than 8 children) never touches the heap.
+// Storage is raw memory: elements are constructed only when they are added.
+// Trivially copyable elements are moved around with memcpy and memmove,
+// others with their move constructor. operator[] and the iterators do not
+// check bounds; at() does.
 
 
 #ifndef VECTOR_H
 #define VECTOR_H
 
 #include<cstdlib>
+#include<cstring>
 #include<iostream>
 #include<sstream>
 #include<vector>
+#include<new>
+#include<utility>
+#include<type_traits>
 #include <stdexcept>
 using namespace std;
 
-template <typename T>
+template <typename T, int N = 8>
 class Vector
 {
     private:
-        T *data;                        //pointer to int(array) to store elements
+        T *data;                        //the elements, either in small or on the heap
         int v_size;                     //current size of vector (number of elements in vector)
         int v_capacity;                 //capacity of vector
+        typename aligned_storage<sizeof(T), alignof(T)>::type small[N > 0 ? N : 1];    //inline storage for the first N elements
+
+        static const bool TRIVIAL = is_trivially_copyable<T>::value;
+
+        bool isSmall() const;           //true while the elements are in the inline buffer
+        T* smallData();
+        static void relocate(T* dest, T* src, int count);   //move count elements to uninitialized memory and destroy the originals
+        void grow(int min_capacity);    //move the elements to a larger heap buffer
+        void release();                 //destroy the elements and free the heap buffer
     public:
+        typedef T* iterator;
+        typedef const T* const_iterator;
+
         Vector(int cap=0);          //Constructor
+        Vector(const Vector& other);
+        Vector(Vector&& other);
+        Vector& operator=(const Vector& other);
+        Vector& operator=(Vector&& other);
         ~Vector();                  //Destructor
         int size() const;               //Return current size of vector
         int capacity() const;           //Return capacity of vector
         bool empty() const;             //Rturn true if the vector is empty, False otherwise
         const T& front();               //Returns reference of the first element in the vector
         const T& back();                //Returns reference of the Last element in the vector
-        void push_back(T element);      //Add an element at the end of vector
-        void insert(int index, T element); //Add an element at the index 
-        void erase(int index);          //Removes an element from the index
-        T& operator[](int index);           //Returns the reference of an element at given index
-        T& at(int index);               //return reference of the element at given index
+        void push_back(const T& element);   //Add an element at the end of vector
+        void push_back(T&& element);
+        template <typename... Args>
+        T& emplace_back(Args&&... args);    //Construct an element at the end of vector
+        void pop_back();                //Remove the last element
+        void insert(int index, T element); //Add an element at the index
+        void erase(int index);          //Removes an element from the index, keeping the order
+        void swap_erase(int index);     //Removes an element from the index in O(1) by moving the last element there
+        void clear();                   //Remove all elements, keeping the capacity
+        void reserve(int cap);          //Make room for cap elements
+        T& operator[](int index);           //Returns the reference of an element at given index, unchecked
+        const T& operator[](int index) const;
+        T& at(int index);               //return reference of the element at given index, checked
+        iterator begin();
+        iterator end();
+        const_iterator begin() const;
+        const_iterator end() const;
         void shrink_to_fit();           //Reduce vector capacity to fit its size
+        size_t heapBytes() const;       //memory held outside the Vector itself
         void display();
 };
 
-// Create a construcotr which creates a vector with the specified capacity.
-template <typename T>
-Vector<T>::Vector(int cap) : v_size(0), v_capacity(cap) {
-    data = new T[v_capacity];//create an array based vector with the given capacity
+template <typename T, int N>
+bool Vector<T, N>::isSmall() const {
+    return data == reinterpret_cast<const T*>(small);
+}
+
+template <typename T, int N>
+T* Vector<T, N>::smallData() {
+    return reinterpret_cast<T*>(small);
+}
+
+//create a function that moves elements to uninitialized memory, with one memcpy when T allows it
+template <typename T, int N>
+void Vector<T, N>::relocate(T* dest, T* src, int count) {
+    if (TRIVIAL) {
+        if (count > 0) {
+            memcpy(static_cast<void*>(dest), static_cast<const void*>(src), count * sizeof(T));
+        }
+        return;
+    }
+    for (int i = 0; i < count; ++i) {
+        new (&dest[i]) T(std::move(src[i]));
+        src[i].~T();
+    }
+}
+
+// Create a function that doubles the capacity (at least to min_capacity) in a new heap buffer
+template <typename T, int N>
+void Vector<T, N>::grow(int min_capacity) {
+    int new_capacity = v_capacity * 2;
+    if (new_capacity < min_capacity) {
+        new_capacity = min_capacity;
+    }
+    T* new_data = static_cast<T*>(::operator new(new_capacity * sizeof(T)));
+    relocate(new_data, data, v_size);
+    if (!isSmall()) {
+        ::operator delete(data);
+    }
+    data = new_data;
+    v_capacity = new_capacity;
+}
+
+template <typename T, int N>
+void Vector<T, N>::release() {
+    if (!TRIVIAL) {
+        for (int i = 0; i < v_size; ++i) {
+            data[i].~T();
+        }
+    }
+    if (!isSmall()) {
+        ::operator delete(data);
+    }
+    data = smallData();
+    v_size = 0;
+    v_capacity = N;
+}
+
+// Create a construcotr which creates a vector with the specified capacity, in the inline buffer if it fits.
+template <typename T, int N>
+Vector<T, N>::Vector(int cap) : data(smallData()), v_size(0), v_capacity(N) {
+    if (cap > N) {
+        grow(cap);
+    }
+}
+
+template <typename T, int N>
+Vector<T, N>::Vector(const Vector& other) : data(smallData()), v_size(0), v_capacity(N) {
+    reserve(other.v_size);
+    if (TRIVIAL) {
+        relocate(data, other.data, other.v_size);//a trivial copy is a plain byte copy
+    } else {
+        for (int i = 0; i < other.v_size; ++i) {
+            new (&data[i]) T(other.data[i]);
+        }
+    }
+    v_size = other.v_size;
+}
+
+//create a move constructor that takes over a heap buffer, or moves the elements out of the other's inline buffer
+template <typename T, int N>
+Vector<T, N>::Vector(Vector&& other) : data(smallData()), v_size(0), v_capacity(N) {
+    *this = std::move(other);
+}
+
+template <typename T, int N>
+Vector<T, N>& Vector<T, N>::operator=(const Vector& other) {
+    if (this != &other) {
+        clear();
+        reserve(other.v_size);
+        for (int i = 0; i < other.v_size; ++i) {
+            new (&data[i]) T(other.data[i]);
+        }
+        v_size = other.v_size;
+    }
+    return *this;
+}
+
+template <typename T, int N>
+Vector<T, N>& Vector<T, N>::operator=(Vector&& other) {
+    if (this != &other) {
+        release();
+        if (other.isSmall()) {
+            relocate(data, other.data, other.v_size);
+            v_size = other.v_size;
+        } else {
+            data = other.data;
+            v_size = other.v_size;
+            v_capacity = other.v_capacity;
+        }
+        other.data = other.smallData();
+        other.v_size = 0;
+        other.v_capacity = N;
+    }
+    return *this;
 }
 
-// Create a destructor which cleans up dynamically allocated memory.
-template <typename T>
-Vector<T>::~Vector() {
-    delete[] data;
+// Create a destructor which destroys the elements and frees the heap buffer, if there is one.
+template <typename T, int N>
+Vector<T, N>::~Vector() {
+    release();
 }
 
 // Create a function that returns the current size (number of elements) of the vector.
 
-template <typename T>
-int Vector<T>::size() const {
+template <typename T, int N>
+int Vector<T, N>::size() const {
     return v_size;//return the size of the vector
 }
 
 // Create a function that returns the capacity (maximum number of elements before resizing) of the vector.
-template <typename T>
-int Vector<T>::capacity() const {
+template <typename T, int N>
+int Vector<T, N>::capacity() const {
     return v_capacity;// return the capacity of a vector
 }
 
 // create a function that returns true if the vector is empty, false otherwise.
-template <typename T>
-bool Vector<T>::empty() const {
+template <typename T, int N>
+bool Vector<T, N>::empty() const {
     return (v_size == 0);//return true if empty, otherwise false
 }
 
 //Create a function that returns a reference to the first element in the vector.Throws an out_of_range exception if the vector is empty.
 
-template <typename T>
-const T& Vector<T>::front() {
+template <typename T, int N>
+const T& Vector<T, N>::front() {
     if (empty()) {
         throw out_of_range("Vector is empty");
     }
@@ -85,105 +234,184 @@ const T& Vector<T>::front() {
 
 // Create a function that returns a reference to the last element in the vector. Throws an out_of_range exception if the vector is empty.
 
-template <typename T>
-const T& Vector<T>::back() {
+template <typename T, int N>
+const T& Vector<T, N>::back() {
     if (empty()) {
         throw out_of_range("Vector is empty");
     }
     return data[v_size - 1];//return the data at back index
 }
 
-template <typename T>
-void Vector<T>::push_back(T element) {
-    // Double the capacity if vector is full
+template <typename T, int N>
+void Vector<T, N>::push_back(const T& element) {
     if (v_size >= v_capacity) {
-        v_capacity = (v_capacity == 0) ? 1 : v_capacity * 2;
-        T *newData = new T[v_capacity];
-        for (int i = 0; i < v_size; ++i) {
-            newData[i] = data[i];
-        }
-        delete[] data;
-        data = newData;
+        T copy(element);//the element may live in this vector
+        grow(v_size + 1);
+        new (&data[v_size++]) T(std::move(copy));
+        return;
+    }
+    new (&data[v_size++]) T(element);
+}
+
+template <typename T, int N>
+void Vector<T, N>::push_back(T&& element) {
+    if (v_size >= v_capacity) {
+        T moved(std::move(element));//the element may live in this vector
+        grow(v_size + 1);
+        new (&data[v_size++]) T(std::move(moved));
+        return;
     }
-    data[v_size++] = element;
+    new (&data[v_size++]) T(std::move(element));
 }
 
-template <typename T>
-void Vector<T>::insert(int index, T element) {
+template <typename T, int N>
+template <typename... Args>
+T& Vector<T, N>::emplace_back(Args&&... args) {
+    if (v_size >= v_capacity) {
+        T element(std::forward<Args>(args)...);
+        grow(v_size + 1);
+        return *new (&data[v_size++]) T(std::move(element));
+    }
+    return *new (&data[v_size++]) T(std::forward<Args>(args)...);
+}
+
+template <typename T, int N>
+void Vector<T, N>::pop_back() {
+    if (empty()) {
+        throw out_of_range("Vector is empty");
+    }
+    data[--v_size].~T();
+}
+
+template <typename T, int N>
+void Vector<T, N>::insert(int index, T element) {
     if (index < 0 || index > v_size) {
         throw out_of_range("Index out of range");
     }
     if (v_size >= v_capacity) {
-        // Double the capacity if vector is full
-        v_capacity = (v_capacity == 0) ? 1 : v_capacity * 2;
-        T *newData = new T[v_capacity];
-        for (int i = 0; i < index; ++i) {
-            newData[i] = data[i];
-        }
-        newData[index] = element;
-        for (int i = index; i < v_size; ++i) {
-            newData[i + 1] = data[i];
+        grow(v_size + 1);
+    }
+    if (TRIVIAL) {
+        memmove(static_cast<void*>(data + index + 1), static_cast<const void*>(data + index), (v_size - index) * sizeof(T));
+    } else if (index < v_size) {
+        //open a gap by moving every element after index one slot up, starting at the end
+        new (&data[v_size]) T(std::move(data[v_size - 1]));
+        for (int i = v_size - 1; i > index; --i) {
+            data[i] = std::move(data[i - 1]);
         }
-        delete[] data;
-        data = newData;
+        data[index].~T();
+    }
+    new (&data[index]) T(std::move(element));
+    v_size++;
+}
+
+template <typename T, int N>
+void Vector<T, N>::erase(int index) {
+    if (index < 0 || index >= v_size) {
+        throw out_of_range("Index out of range");
+    }
+
+    if (TRIVIAL) {
+        memmove(static_cast<void*>(data + index), static_cast<const void*>(data + index + 1), (v_size - index - 1) * sizeof(T));
     } else {
-        for (int i = v_size; i > index; --i) {
-            data[i] = data[i - 1];
+        for (int i = index; i < v_size - 1; ++i) {
+            data[i] = std::move(data[i + 1]); // Move assign to shift elements
         }
-        data[index] = element;
+        data[v_size - 1].~T(); // Call the destructor for the last element
     }
-    v_size++;
+    v_size--;
 }
 
-template <typename T>
-void Vector<T>::erase(int index) {
+template <typename T, int N>
+void Vector<T, N>::swap_erase(int index) {
     if (index < 0 || index >= v_size) {
         throw out_of_range("Index out of range");
     }
+    if (index != v_size - 1) {
+        data[index] = std::move(data[v_size - 1]);
+    }
+    data[--v_size].~T();
+}
 
-    for (int i = index; i < v_size - 1; ++i) {
-        data[i].~T(); // Manually call the destructor for the element
-        new (&data[i]) T(data[i + 1]); // Move construct to shift elements
+template <typename T, int N>
+void Vector<T, N>::clear() {
+    if (!TRIVIAL) {
+        for (int i = 0; i < v_size; ++i) {
+            data[i].~T();
+        }
     }
+    v_size = 0;
+}
 
-    data[v_size - 1].~T(); // Call the destructor for the last element
-    v_size--;
+template <typename T, int N>
+void Vector<T, N>::reserve(int cap) {
+    if (cap > v_capacity) {
+        grow(cap);
+    }
 }
 
-template <typename T>
-T& Vector<T>::operator[](int index) {
+template <typename T, int N>
+T& Vector<T, N>::operator[](int index) {
+    return data[index];
+}
+
+template <typename T, int N>
+const T& Vector<T, N>::operator[](int index) const {
+    return data[index];
+}
+
+template <typename T, int N>
+T& Vector<T, N>::at(int index) {
     if (index < 0 || index >= v_size) {
         throw out_of_range("Index out of range");
     }
     return data[index];
 }
 
-template <typename T>
-T& Vector<T>::at(int index) {
-    return (*this)[index];
+template <typename T, int N>
+typename Vector<T, N>::iterator Vector<T, N>::begin() {
+    return data;
 }
 
+template <typename T, int N>
+typename Vector<T, N>::iterator Vector<T, N>::end() {
+    return data + v_size;
+}
 
-// create a function that reduces the vector’s capacity to fit its size.
-template <typename T>
-void Vector<T>::shrink_to_fit() {
-    
-    if (v_capacity > v_size) {// if the capacity is larger than the size of the vector, make them equal
-        v_capacity = v_size;
-        T* new_data = new T[v_capacity];//create a new array with new capacity
-        for (int i = 0; i < v_size; i++) {
-            new_data[i] = data[i];//transfer the elements front the old array to new array
-        }
-        delete[] data;//delete the elements of  the older array 
-        data = new_data;//assign the new array to the older array
+template <typename T, int N>
+typename Vector<T, N>::const_iterator Vector<T, N>::begin() const {
+    return data;
+}
+
+template <typename T, int N>
+typename Vector<T, N>::const_iterator Vector<T, N>::end() const {
+    return data + v_size;
+}
+
+// create a function that reduces the vector’s capacity to fit its size, going back to the inline buffer when it fits.
+template <typename T, int N>
+void Vector<T, N>::shrink_to_fit() {
+    if (isSmall() || v_capacity == v_size) {
+        return;
     }
+    T* new_data = v_size <= N ? smallData() : static_cast<T*>(::operator new(v_size * sizeof(T)));
+    relocate(new_data, data, v_size);//transfer the elements front the old array to new array
+    ::operator delete(data);
+    data = new_data;
+    v_capacity = v_size <= N ? N : v_size;
 }
-template <typename T>
-void Vector<T>::display() {
+
+template <typename T, int N>
+size_t Vector<T, N>::heapBytes() const {
+    return isSmall() ? 0 : v_capacity * sizeof(T);
+}
+
+template <typename T, int N>
+void Vector<T, N>::display() {
     for (int i = 0; i < v_size; ++i) {
         cout << data[i] << " ";
     }
     cout << endl;
 }
 
-#endif
\ No newline at end of file
+#endif
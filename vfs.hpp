@@ -3,9 +3,35 @@
 // Author       : Aysa Binte masud
 // Version      : 01
 // Date Created : 10 November 2023
-// Date Modified: 19 November 2023
+// Date Modified: 17 October 2026
 // Description  : Virtual filesystem implmentation in C++
 //============================================================================
+//
+// One VFS can be used by several sessions at once, each from its own thread.
+// The namespace lock is held shared by the commands that only read the tree
+// or add to it (ls, cd, pwd, size, find, mkdir, touch) and exclusively by
+// those that move, detach or free Inodes (rm, mv, recover, the bin, load,
+// mount, save), so that while it is shared every parent chain stays as it
+// is. Under it each folder has its own reader-writer lock for its children:
+// mkdir and touch lock only their folder and add their size to the ancestors
+// atomically. The arena, the name index and the snapshot are behind one
+// mutex, the path cache and the journal behind one each.
+// cp -r adds one lazy Inode that shares the subtree it copies (clone.hpp).
+// Before a folder changes, the copies of the folder and of its ancestors
+// are expanded one level each, so while any copy is shared mkdir and touch
+// take the namespace lock exclusively like the other changes. A snapshot
+// of the namespace is such a copy of the root, kept outside the tree and
+// reached read-only under /.snap/name. The contents of a file are in the
+// file store (filestore.hpp) and are guarded by the lock of the file's
+// Inode: write, append and truncate hold it exclusively, cat shared.
+// A checkpoint can be written by a thread of its own: under the exclusive
+// lock it takes copies of the root, the bin items and the snapshots, which
+// is O(1) each, then lays them out in slices of CHECKPOINT_SLICE entries
+// under the shared lock, letting it go between slices, and writes the file
+// holding no lock at all. The copies keep what the tree held when it
+// started, whatever the sessions change meanwhile; they are freed when
+// maintain reports the checkpoint and drops the journal records it holds.
+//
 #ifndef VFS_H
 #define VFS_H
 #include<iostream>
@@ -16,26 +42,97 @@
 #include<fstream>
 #include<sstream>
 #include<vector>
+#include<chrono>
+#include<algorithm>
+#include<mutex>
+#include<atomic>
+#include<thread>
 #include "inode.hpp"
-#include "queue.hpp"
 #include "vector.hpp"
+#include "slabpool.hpp"
+#include "inodetable.hpp"
+#include "loader.hpp"
+#include "snapshot.hpp"
+#include "journal.hpp"
+#include "nameindex.hpp"
+#include "pattern.hpp"
+#include "threadpool.hpp"
+#include "dentrycache.hpp"
+#include "trash.hpp"
+#include "rwlock.hpp"
+#include "session.hpp"
+#include "stats.hpp"
+#include "clone.hpp"
+#include "listing.hpp"
+#include "treewalk.hpp"
+#include "filestore.hpp"
 using namespace std;
 
+//a checkpoint being written in the background, from copies that keep what the tree, the bin and the snapshots held when it started
+struct CheckpointRun
+{
+    string file;                    //snapshot file it writes
+    vector<Inode*> tops;            //copy of the root, then of each bin item and snapshot
+    vector<SnapshotBinItem> items;  //what the copies after the root are
+    uint64_t bin_next_id;
+    uint64_t sequence;              //last journal record it holds
+    uint64_t journal_bytes;         //length of the journal when it started; the records after it are kept
+    InodeTable table;               //laid out a slice at a time
+    TableCursor cursor;
+    thread worker;
+    atomic<bool> cancel;            //stop laying out; set by a command holding the namespace lock exclusively
+    atomic<bool> done;              //the worker is finished and can be joined
+    bool saved;                     //the file was renamed into place
+    chrono::steady_clock::time_point started;
+    double start_pause, walk, write, longest_slice;     //in seconds
+    uint64_t slices;
+
+    CheckpointRun() : bin_next_id(1), sequence(0), journal_bytes(0), cancel(false), done(false), saved(false), start_pause(0), walk(0), write(0), longest_slice(0), slices(0) { }
+};
+
 class VFS
 {
     private:
         Inode *root;                //root of the VFS
-        Inode *curr_inode;          //current iNode
-        Inode *prev_inode;          //previous iNode
-        Queue<Inode*> bin;          //bin containing the deleted Inodes
-        Queue<string> bin_paths;    //paths of the items in bin
+        Session console;            //folders of the interactive shell
+        RWLock namespace_lock;      //shared by commands that keep every parent chain, exclusive for the others
+        mutex index_lock;           //guards the arena, the name index and the snapshot
+        mutex dcache_lock;          //guards the path cache
+        mutex journal_lock;         //orders the appends of concurrent sessions
+        atomic<uint64_t> mount_epoch;       //bumped by mount, which replaces every session's folders
+        atomic<bool> checkpoint_due;        //the journal outgrew CHECKPOINT_BYTES, maintain writes a checkpoint
+        Trash trash;                //removed subtrees by number, original path and time of removal
+        vector<Inode*> purge_stack; //Inodes of purged bin items that are still to be freed
+        uint64_t bin_max_bytes;     //the oldest items are purged while the bin holds more than this
+        int64_t bin_max_age;        //or while they were removed longer ago than this, in seconds
+        static const size_t PURGE_BUDGET = 4096;            //purged Inodes freed after each command
+        SlabPool<Inode> pool;       //arena every Inode of this VFS is allocated from
+        FileStore files;            //blocks holding the contents of the files
+        NameIndex names;            //every Inode except the root, by name, for find
+        CloneSource clones;         //copies made by cp that still share the subtree they copy
+        vector<SnapshotView> views; //point-in-time snapshots of the tree, reached under /.snap
+        unsigned find_threads;      //workers of a pattern search, 0 for one per hardware thread
+        DentryCache dentries;       //recently resolved paths
+        uint64_t generation_clock;  //source of the generations that keep dentries valid
+        InodeTable table;           //compact copy of the tree used for linear scans
+        atomic<uint64_t> tree_version;      //bumped by every change to the tree
+        uint64_t table_version;     //tree_version at the time the table was built
+        uint64_t table_expanded;    //copies expanded by then; the Inodes of a copy expanded later have no entry
+        MappedSnapshot *snapshot;   //mounted snapshot file that lazy Inodes are materialized from
+        Journal journal;            //write-ahead log of the changes since the last checkpoint
+        string checkpoint_file;     //snapshot file a checkpoint writes
+        static const uint64_t CHECKPOINT_BYTES = 64 << 20;  //journal size that triggers a checkpoint
+        CheckpointRun *background;  //checkpoint being written by its own thread, nullptr if none
+        static const size_t CHECKPOINT_SLICE = 16384;       //entries a background checkpoint lays out per hold of the lock
+        static const int CHECKPOINT_PAUSE = 100;            //microseconds between its slices, for the commands waiting to change the tree
     
     public:     
         //Required methods
         VFS();  
+        ~VFS();
         void help();                        
         string pwd();
-        void ls();                      
+        void ls(string options = "");   
         void mkdir(string folder_name);
         void touch(string file_name, unsigned int size);
         void cd(string path);
@@ -44,33 +141,157 @@ class VFS
         void showbin();
         void emptybin();
         void exit();
-        
+
+        //the same commands for one of several concurrent sessions
+        string pwd(Session& s);
+        void ls(Session& s, const string& options = "");
+        void mkdir(Session& s, string folder_name);
+        void touch(Session& s, string file_name, unsigned int size);
+        void cd(Session& s, string path);
+        void rm(Session& s, string file_name);
+        void size(Session& s, string path);
+        void find(Session& s, string name);
+        void findPattern(Session& s, const string& pattern, bool is_regex);
+        void mv(Session& s, string file, string folder);
+        void recover(Session& s, string item);
+        void cp(Session& s, string source, string destination, bool recursive);
+        void writeFile(Session& s, string path, const string& text, bool append);
+        void cat(Session& s, string path);
+        void truncate(Session& s, string path, string length);
         
         //Optional methods
         void find(string name);
+        void findPattern(const string& pattern, bool is_regex);    //find the names matching a wildcard or a regular expression
+        void setFindThreads(unsigned threads);
+        void dcache();                      //prints the statistics of the path cache
         void mv(string file, string folder);
-        void recover();
+        void recover(string item);          //put back the oldest item, an item by number or by original path
+        void cp(string source, string destination, bool recursive);    //copy a file, or a folder with -r, sharing its subtree until either side changes
+        void writeFile(string path, const string& text, bool append);  //replace the contents of a file by text, or append text to them
+        void cat(string path);              //print the contents of a file
+        void truncate(string path, string length);      //cut a file, or extend it with zeros
+        void binlimit(string bytes, string seconds);    //set the size and age limits of the bin
+        void cache(string megabytes);       //prints the statistics of the page cache of the contents, or sets its size
+        CacheStats cacheStats();
+        void df();                          //prints the bytes of the files against the blocks that hold them
+        DedupStats dedupStats();
+        void maintain();                    //after every command: purge what is over the bin limits and free a share of it
+        void arena();                       //prints the occupancy of the Inode arena
+        void compact();                     //builds the Inode table and compares its memory use with the tree
+        void stats(string option, string file);     //prints the command latencies and the counters, as JSON, or resets them
+        void snapshotCommand(string action, string name);  //create, list or drop a point-in-time snapshot of the tree
 
         //Optional helper methods
-        // void load(ifstream &fin);                //Helper method to load the vfs.dat
-        void find_helper(Inode* ptr, string name,string currentPath);
-        Inode* getNode(string path);            //Helper method to get a pointer to iNode at given path
+        bool load(const string& filename);         //Helper method to load the vfs.dat
+        bool save(const string& filename);         //write the tree as a binary snapshot
+        bool mount(const string& filename);        //replace the tree by a mapped snapshot
+        bool openJournal(const string& journal_file, const string& snapshot_file); //replay the journal, then log to it
+        bool checkpoint();                         //save the snapshot and empty the journal
+        void checkpointCommand(string option);     //start a checkpoint in the background, wait for it, or write one now
+        bool startCheckpoint();                    //copy the tree and start the thread that writes it
+        void checkpointWorker(CheckpointRun* run); //lay out the copies in slices, then write them
+        bool waitCheckpoint();                     //wait for the background checkpoint and report it, false if there is none
+        void finishCheckpoint(bool cancel);        //join the background checkpoint, free its copies and compact the journal
+        void journalCommand(string policy);        //set the sync policy and print the journal statistics
+        void find_helper(Inode* ptr, const string& name, const string& currentPath);
+        Inode* getNode(string path, bool quiet = false); //Helper method to get a pointer to iNode at given path
+        Inode* readNode(const string& path, bool quiet, Inode** anchor = nullptr, string* below = nullptr); //the Inode a path shows, read through copies without expanding them
+        Inode* resolve(const string& path, bool quiet, bool expand, Inode** anchor, string* below);
+        Inode* walk(Inode* current, const char* p, size_t pos, size_t length, bool quiet, bool expand, Inode** anchor, string* below); //follow the components of p from current
+        bool pathOf(Inode* ptr, string& path);          //absolute path of an Inode, false if it is not in the tree
         Inode* getChild(Inode *ptr, string childname);  //returns a specific child of given Inode
         // bool find_helper(Inode *ptr, string name);       //recursive method to check if a given child is present under specific Inode or not
         // void updateSize(Inode *ptr);                    //re-calculatre the size of an Inode and its parents
-        void write(ofstream &fout, Inode *ptr);         //traverse and write recrusively the vfs data
-        string getTime();                               //return system time as an string
-        void calculateFolderSize(Inode* folder, unsigned int& totalSize);
+        void write(ofstream &fout, Inode *ptr);         //write the vfs data in the format read by load
+        int64_t getTime();                              //return system time in seconds since the epoch
+        bool tableCurrent();                            //true if the Inode table matches the tree
+        void propagateSize(Inode* ptr, int64_t delta);  //add a size difference to an Inode and all its ancestors
+        void purgeItem(TrashItem* item);                //take an item out of the bin; its Inodes are freed by purgeStep
+        size_t purgeStep(size_t budget);                //free at most budget purged Inodes, returns how many were freed
+        Inode* createChild(Inode* parent, const string& name, bool type, uint64_t size, int64_t cr_time); //add a new Inode under parent
+        const char* nameError(Inode* folder, const string& name);  //why name cannot be given to a child of folder, nullptr if it can
+        void storeContents(Inode* file, const char* bytes, size_t length, bool append);   //write a file from the start or after its end, with its lock held
+        void resizeContents(Inode* file, uint64_t length);  //set the size of a file, with its lock held
+        template <typename F>
+        void readContents(Inode* file, uint64_t offset, uint64_t length, F fn); //fn(pointer, length) over the bytes of a file, with its lock held
+        void moveToBin(Inode* parent, Inode* target);   //detach target and put it in the bin
+        void binPath(TrashItem* item, string& path);    //original path of a bin item
+        void freezePaths(Inode* top);                   //write the paths of the bin items read through top or below it, before top moves
+        void countHolds(Inode* folder, int64_t delta);  //add to the bin items held by folder and its ancestors
+        void rebase(Inode* top, uint32_t depth);        //renumber the depths below top after it was attached at depth
+        void moveChild(Inode* target, Inode* folder);   //detach target and attach it under folder
+        Inode* copyInto(Inode* folder, Inode* source, const string& name); //add a copy of source to folder, sharing the subtree of source
+        void unshare(Inode* folder);                    //expand the copies that show folder as it is, before it changes
+        bool hasCopies();                               //true while a copy shares a subtree
+        Inode* readThrough(Inode* folder);              //the Inode whose children folder shows: folder, or what a copy copies
+        void clonePaths(Inode* node, const string& below, vector<string>& found);  //paths at which what is below node shows inside copies
+        bool contains(Inode* folder, Inode* node);      //true if node is folder or below it
+        string absolutePath(Inode* dir, const string& path);    //a path relative to dir made absolute
+        string absolutePath(Session& s, const string& path);    //a path relative to the current folder of a session made absolute
+        string folderPath(Session& s);                  //path of the current folder of a session, after enter
+        Inode* createView(const string& name, int64_t created); //take a snapshot of the tree, nullptr if the name is taken
+        bool dropView(const string& name);              //queue the Inodes of a snapshot for freeing
+        Inode* findView(const string& name);            //the root of a snapshot by name
+        Inode* viewOf(Inode* node);                     //the root of the snapshot node is in, nullptr in the tree or the bin
+        bool isView(Inode* node);                       //true if node is the root of a snapshot
+        void footprint(Inode* top, size_t& inodes, size_t& bytes);    //the Inodes of a subtree and the memory they hold, without what copies share
+        void listPage(Inode* folder, const ListOptions& options, ostream& out);    //the entries of a folder in order, after a cursor, with a prefix
+        bool recoverItem(TrashItem* item);              //put a bin item back under its parent, false if it has to stay in the bin
+        TrashItem* findBinItem(Inode* dir, const string& key);  //the oldest item, or the one with that number or original path (relative to dir)
+        bool attached(Inode* ptr);                      //true if the parent chain of ptr reaches the root, or the root of a snapshot
+        Inode* enter(Session& s, bool expand = true);   //the current folder of a session (without expand, the folder it shows), which moves to the root if the folder is gone
+        bool alive(Inode* node, uint64_t ino);          //true if node is still that Inode and in the tree
+        void setFolder(Session& s, Inode* folder, string below = "");  //make folder, or the path below it inside a copy, the current folder of a session
+        void materialize(Inode* folder);                //create the children of a lazy folder under its exclusive lock
+        void clearBin();                                //purge every item in the bin
+        void logChange(Inode* dir, uint8_t type, const string& name, const string& target, uint64_t size, int64_t cr_time); //append and commit a journal record for a change in dir
+        bool apply(const JournalRecord& record);        //redo a journal record, false if it no longer applies
 };
 
+const size_t VFS::CHECKPOINT_SLICE;
+const int VFS::CHECKPOINT_PAUSE;
 
 //constructor of the class
-VFS::VFS() {
-    // Initialize root, previous inode and current inode to nullptr
-    root = new Inode("Root", nullptr, Folder, 0, getTime()); // Initialize the root with its name, parent as nullptr, type, and time
-    curr_inode = root;//initialize current inode as root
-    prev_inode = nullptr;//initialize previous inode as nullptr
+VFS::VFS() : clones(&pool, &names) {
+    // Initialize the root; the current and previous inodes belong to the sessions
+    root = pool.create("Root", nullptr, Folder, 0, getTime()); // Initialize the root with its name, parent as nullptr, type, and time
+    mount_epoch = 1;//the sessions start at the root on their first command
+    checkpoint_due = false;
+    tree_version = 1;//no table has been built yet
+    table_version = 0;
+    table_expanded = 0;
+    snapshot = nullptr;
+    background = nullptr;
+    find_threads = 0;
+    generation_clock = 0;
+    bin_max_bytes = 1ULL << 30;//1 GB
+    bin_max_age = 30 * 24 * 3600;//30 days
+}
+
+//destructor of the class, releases every Inode (the tree, the bin and what is being purged) slab by slab
+VFS::~VFS() {
+    finishCheckpoint(true);//its thread reads the Inodes and the contents
+    pool.reset();
+    files.reset();
+    delete snapshot;//no Inode or contents refer to the mapping any more
 }
+
+//the commands of the interactive shell run in its own session
+string VFS::pwd() { return pwd(console); }
+void VFS::ls(string options) { ls(console, options); }
+void VFS::mkdir(string folder_name) { mkdir(console, folder_name); }
+void VFS::touch(string file_name, unsigned int size = 10) { touch(console, file_name, size); }
+void VFS::cd(string path) { cd(console, path); }
+void VFS::rm(string file_name) { rm(console, file_name); }
+void VFS::size(string path) { size(console, path); }
+void VFS::find(string name) { find(console, name); }
+void VFS::findPattern(const string& pattern, bool is_regex) { findPattern(console, pattern, is_regex); }
+void VFS::mv(string file, string folder) { mv(console, file, folder); }
+void VFS::recover(string item) { recover(console, item); }
+void VFS::cp(string source, string destination, bool recursive) { cp(console, source, destination, recursive); }
+void VFS::writeFile(string path, const string& text, bool append) { writeFile(console, path, text, append); }
+void VFS::cat(string path) { cat(console, path); }
+void VFS::truncate(string path, string length) { truncate(console, path, length); }
 //===========================================================
 //create a function to print all the command lines
 void VFS::help() {
@@ -78,6 +299,7 @@ void VFS::help() {
         cout << "1. help : Prints the menu of commands." << endl;
         cout << "2. pwd : Prints the path of the current inode." << endl;
         cout << "3. ls : Prints the children of the current inode." << endl;
+        cout << "    ls [--sort name|size|time] [--limit N] [--after name] [prefix*] : Prints a sorted page of the children." << endl;
         cout << "4. mkdir foldername : Creates a folder under the current folder." << endl;
         cout << "5. touch filename size : Creates a file under the current inode location with the specified filename, size, and current datetime." << endl;
         cout << "6. cd foldername : Change current inode to the specified folder." << endl;
@@ -87,70 +309,173 @@ void VFS::help() {
         cout << "11. cd : Changes current inode to root." << endl;
         cout << "12. cd /my/path/name: Changes the current inode to the specified path if it exists." << endl;
         cout << "13. find foldername or find filename : Returns the path of the file or the folder if it exists." << endl;
+        cout << "    find pattern or find -r regex : Returns the paths of the names matching a wildcard (* ? [...]) or a regular expression." << endl;
         cout << "14. mv filename foldername : Moves a file located under the current inode location to the specified folder path." << endl;
-        cout << "15. rm foldername or rm filename : Removes the specified folder or file and puts it in a Queue of MAXBIN=10." << endl;
+        cout << "15. rm foldername or rm filename : Removes the specified folder or file and puts it in the bin (the oldest items are purged beyond the bin limits)." << endl;
         cout << "16. size foldername or filename : Returns the total size of the folder, including all its subfiles, or the size of the file." << endl;
         cout << "17. emptybin : Empties the bin." << endl;
-        cout << "18. showbin : Shows the oldest inode of the bin, including its path." << endl;
-        cout << "19. recover : Reinstates the oldest inode back from the bin to its original position in the tree." << endl;
+        cout << "18. showbin : Shows the items of the bin, oldest first, with their number, time of removal, size and path." << endl;
+        cout << "19. recover [number|path] : Reinstates the oldest item, or the given one, from the bin to its original position in the tree." << endl;
         cout << "20. exit : Stops the program." << endl;
+        cout << "21. arena : Shows the occupancy of the Inode arena." << endl;
+        cout << "22. compact : Builds the compact Inode table used by find, size and write, and compares its memory use." << endl;
+        cout << "23. load filename : Adds the entries of a file in the vfs.dat format to the tree." << endl;
+        cout << "24. save filename : Saves the tree as a binary snapshot (vfs.snap by default)." << endl;
+        cout << "25. mount filename : Replaces the tree by a binary snapshot, which is mapped and read on demand." << endl;
+        cout << "26. checkpoint [wait|now] : Saves the tree and the bin to vfs.snap in the background and then drops the journal records it holds; wait waits for it, now writes one before returning." << endl;
+        cout << "27. journal [always|batch|none] : Sets when the journal is flushed to disk and shows its statistics." << endl;
+        cout << "28. dcache : Shows the hit rate of the path cache." << endl;
+        cout << "29. binlimit [bytes] [seconds] : Sets the size and age beyond which the oldest bin items are purged." << endl;
+        cout << "30. stats [json [filename]|reset] : Shows the latency of each command, the internal counters, the bin and the arena." << endl;
+        cout << "31. cp [-r] source destination : Copies a file, or a folder with -r; the copy shares the subtree until either side changes." << endl;
+        cout << "32. snapshot create|list|drop [name] : Takes, lists or drops a read-only snapshot of the tree, reached as /.snap/name." << endl;
+        cout << "33. write file text : Replaces the contents of a file by the text, creating the file if it does not exist." << endl;
+        cout << "34. append file text : Adds the text at the end of a file, creating the file if it does not exist." << endl;
+        cout << "35. cat file : Prints the contents of a file." << endl;
+        cout << "36. truncate file size : Cuts a file to the size, or extends it with zeros." << endl;
+        cout << "37. cache [MB] : Shows the hit rate and the write-back of the page cache of the contents, or sets its size." << endl;
+        cout << "38. df : Shows the bytes of the files against the blocks that store them once for identical contents." << endl;
     }
 
-//create a method to get the node at a specified path
-Inode* VFS::getNode(string path) {
+//create a method to get the node at a specified path, expanding the copies on the way so that it can be changed
+Inode* VFS::getNode(string path, bool quiet) {
+    return resolve(path, quiet, true, nullptr, nullptr);
+}
+
+//create a method that gets the node a path shows for reading; inside a copy that is the Inode of what it copies, and anchor and below tell where the path really is
+Inode* VFS::readNode(const string& path, bool quiet, Inode** anchor, string* below) {
+    Inode* held;
+    string rest;
+    return resolve(path, quiet, false, anchor != nullptr ? anchor : &held, below != nullptr ? below : &rest);
+}
+
+//create a method that resolves an absolute path through the cache, then component by component
+Inode* VFS::resolve(const string& path, bool quiet, bool expand, Inode** anchor, string* below) {
+    VFS_COUNT(S_PATHS, 1);
+    if (anchor != nullptr) {
+        *anchor = root;
+        below->clear();
+    }
 
     //if the path is at root, return root
-    if (path == "/") {
+    if (path == "/" || path.empty()) {
         return root;
     }
 
     //if the path does not start with "/", it's invalid. Check the validity.
     if (path[0] != '/') {
-        cout << "Invalid path format. Path must start with '/'.";
+        if (!quiet) {
+            cout << "Invalid path format. Path must start with '/'.";
+        }
         return nullptr;
     }
 
-    // parse the path
-    vector<string> tokens;
-    stringstream ss(path);
-    string token;
-
-    // tokenize the path
-    while (getline(ss, token, '/')) { 
-        //if it finds a '/', that means, it is a different file/folder name
-
-        //if token exists, then push back to tokens
-        if (!token.empty()) {
-            tokens.push_back(token);
+    const char* p = path.data();
+    size_t length = path.size();
+    size_t pos = length;
+    Inode* current;
+
+    //a path in a snapshot starts at the snapshot's root; such paths are not cached
+    bool in_view = length >= 6 && memcmp(p, "/.snap", 6) == 0 && (length == 6 || p[6] == '/');
+    if (in_view) {
+        pos = 7;
+        while (pos < length && p[pos] != '/') {
+            pos++;
+        }
+        current = length > 7 ? findView(string(p + 7, pos - 7)) : nullptr;
+        if (current == nullptr) {
+            if (!quiet) {
+                cout << "Snapshot not found: " << (length > 7 ? string(p + 7, pos - 7) : string()) << endl;
+            }
+            return nullptr;
         }
     }
 
-    //set the current node to root
-    Inode* current = root;
+    //a path that was resolved before is a single probe of the cache
+    if (!in_view) {
+        lock_guard<mutex> guard(dcache_lock);
+        current = dentries.lookup(p, length, root, generation_clock);
+        if (current != nullptr) {
+            if (anchor != nullptr) {
+                *anchor = current;//only paths in the tree are cached
+            }
+            return current;
+        }
 
+        //otherwise start from the longest cached prefix, or from the root
+        current = dentries.lookupPrefix(p, pos, root, generation_clock);
+    }
+    if (current == nullptr) {
+        current = root;
+        pos = 0;
+    }
 
-    //check the children of each node 
-    for (const string& token : tokens) {
-        Vector<Inode*>& children = current->getChildren();
-        bool found = false;
+    //look up each remaining component in the child index of the current node
+    current = walk(current, p, pos, length, quiet, expand, anchor, below);
+    if (current == nullptr) {
+        return nullptr;
+    }
 
-        // Check if the token matches a child inode's name
-        for (size_t i = 0; i < children.size(); ++i) {//traverse through the vector containing children
+    if (in_view || (anchor != nullptr && *anchor != current)) {//what a copy shows is not cached under the copy's path
+        return current;
+    }
+    lock_guard<mutex> guard(dcache_lock);
+    dentries.insert(p, length, current, generation_clock);
+    return current;//return the current node
+}
 
-            if (children[i]->getName() == token) {//if token matches the name
-                current = children[i];
-                found = true;
-                break;
-            }
+//create a method that looks each component up in the children of the folder before it; a copy that is not expanded is either expanded or read through what it copies
+Inode* VFS::walk(Inode* current, const char* p, size_t pos, size_t length, bool quiet, bool expand, Inode** anchor, string* below) {
+    bool through = false;//the walk left the Inodes of the path for those of what a copy copies
+    if (anchor != nullptr) {
+        *anchor = current;
+        below->clear();
+    }
+    while (pos < length) {
+        size_t first = pos;
+        while (first < length && p[first] == '/') {//empty components are skipped
+            first++;
+        }
+        if (first == length) {
+            break;
+        }
+        size_t last = first;
+        while (last < length && p[last] != '/') {
+            last++;
         }
 
-        if (!found) { //if the token couldn't be found
-            cout << "Path not found: " << token << endl;
+        Inode* next = nullptr;
+        VFS_COUNT(S_COMPONENTS, 1);
+        if (current->getType() == Folder) {
+            Inode* shown = expand ? current : readThrough(current);
+            if (shown == current) {
+                materialize(current);//a folder still in the mounted snapshot is created either way
+            }
+            through = through || shown != current;
+            SharedGuard<SpinRWLock> folder(shown->dir_lock);
+            next = shown->lookupChild(p + first, last - first);
+        }
+        if (next == nullptr) { //if the component couldn't be found
+            if (!quiet) {
+                cout << "Path not found: " << string(p + first, last - first) << endl;
+            }
             return nullptr;
         }
+        current = next;
+        pos = last;
+        if (anchor == nullptr) {
+            continue;
+        }
+        if (!through) {
+            *anchor = current;
+        } else {
+            if (!below->empty()) {
+                *below += '/';
+            }
+            below->append(p + first, last - first);
+        }
     }
-
-    return current;//return the current node
+    return current;
 }
 
 //create a method to get all the clild nodes of the given inode
@@ -161,14 +486,10 @@ Inode* VFS::getChild(Inode* parent, string childName) {
         return nullptr;
     }
 
-    Vector<Inode*>& children = parent->getChildren();//store all the children in a Vector
-
-    //traverse through all the children
-    for (size_t i = 0; i < children.size(); ++i) {
-        if (children[i]->getName() == childName) {
-        //if one of the children's name matches with the given childName, return that child
-            return children[i];
-        }
+    //look the name up in the child index of the parent
+    Inode* child = parent->lookupChild(childName);
+    if (child != nullptr) {
+        return child;
     }
 
     //if the given childName can not be found in the current directory, show the error message.
@@ -176,462 +497,2206 @@ Inode* VFS::getChild(Inode* parent, string childName) {
     return nullptr;
 }
 
+//create a method that writes a subtree (of the tree) in the vfs.dat format, one path,size,date line per Inode
 void VFS::write(ofstream &fout, Inode* ptr) {
     if (ptr == nullptr) {
         return;
     }
 
-    fout << ptr->getName() << " " << ptr->getType() << " " << ptr->getSize() << " " << ptr->getCreationTime() << endl;
-
-    Vector<Inode*>& children = ptr->getChildren();
-    for (size_t i = 0; i < children.size(); ++i) {
-        write(fout, children[i]);
+    //the subtree is a contiguous range of the table, so writing it is a linear scan
+    ExclusiveGuard<RWLock> guard(namespace_lock);
+    if (!tableCurrent()) {
+        table.build(root);
+        table_version = tree_version;
+        table_expanded = clones.expandedCount();
     }
+    table.write(fout, ptr->table_index);
 }
 
-// Get the current working directory
-string VFS::pwd() {
-
-    //if the path is at root, return root
-    if (curr_inode == root) {
-        return "/";
+//create a method that loads a file in the vfs.dat format, where parents are listed before their children
+bool VFS::load(const string& filename) {
+    ExclusiveGuard<RWLock> guard(namespace_lock);
+    LineReader reader;
+    if (!reader.open(filename)) {
+        cout << "Could not open '" << filename << "'." << endl;
+        return false;
     }
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+    //levels[k] is the folder named by the first k components of dir, with the length of that prefix of dir
+    vector<pair<size_t, Inode*> > levels(1, make_pair((size_t)0, root));
+    string dir;                             //parent folder of the previous entry
+    string date_key;                        //date field of the previous entry
+    int64_t date_epoch = getTime();         //and its value
+    uint64_t lines = 0, added = 0, skipped = 0;
+
+    const char* line;
+    size_t length;
+    while (reader.next(line, length)) {
+        lines++;
+        if (length == 0) {
+            continue;
+        }
 
+        //split the line into path, size and date
+        const char* comma1 = static_cast<const char*>(memchr(line, ',', length));
+        const char* comma2 = comma1 != nullptr ? static_cast<const char*>(memchr(comma1 + 1, ',', line + length - comma1 - 1)) : nullptr;
+        size_t path_length = comma1 != nullptr ? comma1 - line : length;
+        uint64_t size = 0;
+        if (comma1 != nullptr) {
+            const char* size_end = comma2 != nullptr ? comma2 : line + length;
+            parseUnsigned(comma1 + 1, size_end - comma1 - 1, size);
+        }
+        if (comma2 != nullptr) {
+            size_t date_length = line + length - comma2 - 1;
+            if (date_key.size() != date_length || memcmp(date_key.data(), comma2 + 1, date_length) != 0) {
+                //dates repeat from line to line, so only a new one is converted
+                if (!parseDate(comma2 + 1, date_length, date_epoch)) {
+                    date_epoch = getTime();
+                }
+                date_key.assign(comma2 + 1, date_length);
+            }
+        }
 
-    string path = "";//initialize the path as an empty string
-    Inode* temp = curr_inode;//set the temporary Inode pointer as curr_inode
+        //a trailing '/' marks a folder
+        bool folder_mark = false;
+        while (path_length > 1 && line[path_length - 1] == '/') {
+            path_length--;
+            folder_mark = true;
+        }
+        if (path_length == 0 || line[0] != '/') {
+            skipped++;
+            continue;
+        }
+        if (path_length == 1) {//the root itself
+            continue;
+        }
+        size_t slash = path_length - 1;
+        while (line[slash] != '/') {
+            slash--;
+        }
 
-    while (temp != root) {//until the temporary inode pointer reaches to root
-        path = "/" + temp->getName() + path; //assign the new path of "/parentNode/childnode's path" of this format to path
-        temp = temp->getParent(); //forward the temporary inode pointer to its parent
-    }
+        //keep the cached folders that are also a prefix of this entry's parent
+        size_t common = 0;
+        size_t limit = min(slash, dir.size());
+        while (common < limit && dir[common] == line[common]) {
+            common++;
+        }
+        while (levels.size() > 1) {
+            size_t e = levels.back().first;
+            if (e <= common && (e == slash || line[e] == '/')) {
+                break;
+            }
+            levels.pop_back();
+        }
 
-    return path;
-}
+        //resolve the remaining components of the parent from the deepest cached folder
+        Inode* parent = levels.back().second;
+        size_t pos = levels.back().first;
+        while (pos < slash) {
+            size_t first = pos + 1;
+            size_t last = first;
+            while (last < slash && line[last] != '/') {
+                last++;
+            }
+            if (last > first) {
+                Inode* next = parent->lookupChild(line + first, last - first);
+                if (next == nullptr) {//a parent that was not listed is created as a folder
+                    string component(line + first, last - first);
+                    if (nameError(parent, component) != nullptr) {
+                        parent = nullptr;
+                        break;
+                    }
+                    next = createChild(parent, component, Folder, FOLDER_SIZE, date_epoch);
+                } else if (next->getType() == File) {//an entry with children is a folder
+                    unshare(next);
+                    int64_t delta = static_cast<int64_t>(FOLDER_SIZE) - static_cast<int64_t>(next->getSize());
+                    next->type = Folder;
+                    propagateSize(next, delta);
+                }
+                parent = next;
+                levels.push_back(make_pair(last, parent));
+            }
+            pos = last;
+        }
+        if (parent == nullptr) {//under /.snap, which is reserved
+            skipped++;
+            continue;
+        }
+        dir.assign(line, slash);
 
-// List contents of the current directory
-void VFS::ls() {
-    Vector<Inode*>& children = curr_inode->getChildren();//store all the children in a Vector
+        const char* name = line + slash + 1;
+        size_t name_length = path_length - slash - 1;
+        if (parent->lookupChild(name, name_length) != nullptr) {//listed twice, or created above as a parent
+            continue;
+        }
+        if (nameError(parent, string(name, name_length)) != nullptr) {
+            skipped++;
+            continue;
+        }
+        //without a trailing '/', a name without an extension is a folder
+        bool type = (folder_mark || memchr(name, '.', name_length) == nullptr) ? Folder : File;
+        createChild(parent, string(name, name_length), type, type == Folder ? FOLDER_SIZE : size, date_epoch);
+        added++;
+    }
 
-    //traverse through all the children
-    for (size_t i = 0; i < children.size(); ++i) {
-        cout << (children[i]->getType() == Folder ? "dir" : "file") << " ";//if the type is a folder, print "dir", otherwise "file"
-        cout << children[i]->getName() << " ";//print the name of the file/folder
-        
-        cout << children[i]->getCreationTime() << " " ;//print the creation time
-        cout << children[i]->getSize() << " "<< "bytes"<<endl;//print the size in bytes
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "Loaded " << added << " entries from " << lines << " lines of '" << filename << "'";
+    if (skipped > 0) {
+        cout << " (" << skipped << " malformed lines skipped)";
     }
+    cout << " in " << fixed << setprecision(3) << seconds << " s, " << setprecision(0)
+         << (seconds > 0 ? lines / seconds : 0.0) << " lines/sec." << endl;
+    cout.unsetf(ios::fixed);
+    cout << setprecision(6);
+    if (journal.isOpen()) {//loaded entries are not journaled, so they go into a checkpoint
+        checkpoint();
+    }
+    return true;
 }
 
-//create a method which creates a folder with a given name
-void VFS::mkdir(string folder_name) {
-
-    if (curr_inode == nullptr) {//show an error message, if the is no current working directory
-        cout << "No current directory selected." << endl;
-        return;
+//create a method that saves the whole tree and the bin as a binary snapshot that mount can map
+bool VFS::save(const string& filename) {
+    ExclusiveGuard<RWLock> guard(namespace_lock);
+    if (background != nullptr && background->file == filename) {
+        finishCheckpoint(true);//both would write the same temporary file
     }
-
-
-    //create a new folder with given node, crrrent inode as the parent node, default size 10 bytes and the creation time
-    Inode* new_folder = new Inode(folder_name, curr_inode, Folder, 10, getTime());
-
-    //push the newly created folder in the Vector containing the children of current inode
-    curr_inode->getChildren().push_back(new_folder);
-    
-    // Update the size of the current inode
-
-    unsigned int totalSize = 0;//at first, initialize the total size with zero
-
-    Vector<Inode*>& children = curr_inode->getChildren();//store all the children in a Vector
-
-    for (size_t i = 0; i < children.size(); ++i) {//traverse through each child and add the size to parent node
-        totalSize += children[i]->getSize();
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+    //the bin items follow the tree, oldest first
+    vector<Inode*> nodes;
+    vector<SnapshotBinItem> items;
+    for (TrashItem* item = trash.oldest(); item != nullptr; item = item->newer) {
+        SnapshotBinItem saved = {item->id, item->deleted, ""};
+        binPath(item, saved.path);
+        nodes.push_back(item->node);
+        items.push_back(saved);
     }
+    //then the snapshots of the tree, numbered 0
+    for (size_t i = 0; i < views.size(); ++i) {
+        SnapshotBinItem saved = {0, views[i].created, "/.snap/" + views[i].name};
+        nodes.push_back(views[i].root);
+        items.push_back(saved);
+    }
+    table.build(root, nodes);
+    table_version = tree_version;
+    table_expanded = clones.expandedCount();
+
+    //everything journaled so far is in the snapshot
+    journal.sync();
+    if (!table.save(filename, files, items, trash.nextId(), journal.nextSequence() - 1)) {
+        cout << "Could not save to '" << filename << "'." << endl;
+        return false;
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "Saved " << table.count() << " Inodes to '" << filename << "' in " << fixed << setprecision(3) << seconds << " s." << endl;
+    cout.unsetf(ios::fixed);
+    cout << setprecision(6);
+    return true;
+}
 
-    curr_inode->setSize(totalSize);//set the new size as the size of the directory
-
-    // Update parent sizes
-    Inode* temp = curr_inode;
-    while (temp != nullptr) {//stops after traversing through the root directory
+//create a method that replaces the tree by a snapshot; only the root is created, folders are materialized on first use
+bool VFS::mount(const string& filename) {
+    ExclusiveGuard<RWLock> guard(namespace_lock);
+    finishCheckpoint(true);//the tree it copies is going
+    MappedSnapshot* mapped = new MappedSnapshot(&pool, &names, &files);
+    string error;
+    if (!mapped->open(filename, error)) {
+        cout << "Could not mount: " << error << "." << endl;
+        delete mapped;
+        return false;
+    }
 
-        unsigned int parentSize = 0;//at first, initialize the total size with zero
-        Vector<Inode*>& parentChildren = temp->getChildren();//store all the children in a Vector
-        for (size_t i = 0; i < parentChildren.size(); ++i) {//traverse through each child and add the size to parent node
-            parentSize += parentChildren[i]->getSize();
+    //drop the current tree and the bin, then the old mapping nothing refers to any more
+    trash.clear();
+    purge_stack.clear();
+    views.clear();
+    clones.clear();
+    pool.reset();
+    files.reset();
+    names.clear();
+    dentries.clear();
+    delete snapshot;
+    snapshot = mapped;
+
+    root = snapshot->createRoot();
+    //the parents of the bin items are found by their paths when they are recovered
+    for (uint32_t k = 0; k < snapshot->binCount(); ++k) {
+        if (snapshot->binId(k) == 0) {//a snapshot of the tree
+            SnapshotView view = {snapshot->binPath(k).substr(7), snapshot->createBinItem(k), snapshot->binDeleted(k)};
+            views.push_back(view);
+            continue;
         }
-        temp->setSize(parentSize);//set the new updated size
-        temp = temp->getParent();//forward it to the parent inode
+        trash.add(snapshot->createBinItem(k), nullptr, snapshot->binPath(k), snapshot->binDeleted(k), snapshot->binId(k));
     }
-
-    //print a message to lett the user know that the folder has been created
-    cout << "Folder '" << folder_name << "' created." << endl;
+    trash.setNextId(snapshot->binNextId());
+    mount_epoch++;//every session starts over at the new root
+    tree_version++;
+    cout << "Mounted '" << filename << "' with " << snapshot->count() << " Inodes." << endl;
+    if (journal.isOpen()) {//the journal holds changes to the old tree
+        checkpoint();
+    }
+    return true;
 }
 
-
-//create a method that creates a file with a given name, and size
-void VFS::touch(string file_name, unsigned int size = 10) {
-
-    if (curr_inode == nullptr) {//show an error message, if the is no current working directory
-        cout << "No current directory selected." << endl;
-        return;
+//create a method that replays the records written after the current snapshot, then opens the journal for appending
+bool VFS::openJournal(const string& journal_file, const string& snapshot_file) {
+    ExclusiveGuard<RWLock> guard(namespace_lock);
+    checkpoint_file = snapshot_file;
+    vector<JournalRecord> records;
+    if (!Journal::replay(journal_file, records)) {
+        cout << "Could not read the journal '" << journal_file << "'." << endl;
+        return false;
     }
-    
-    //check whether the user provides a valid name or not
-    for (char ch : file_name) {
-        // Check if the character is alphanumeric or a period
-        if (!std::isalnum(ch) && ch != '.') {
-            cout<<"File names should be alphaneumeric only. Try again!"<<endl;
-            return ;
+
+    //records up to the snapshot's sequence number are already part of it
+    uint64_t last = snapshot != nullptr ? snapshot->journalSequence() : 0;
+    uint64_t applied = 0, failed = 0;
+    for (size_t i = 0; i < records.size(); ++i) {
+        if (records[i].sequence <= last) {
+            continue;
+        }
+        if (apply(records[i])) {
+            applied++;
+        } else {
+            failed++;
         }
+        last = records[i].sequence;
     }
 
-    //create a new file with given information
-    Inode* new_file = new Inode(file_name, curr_inode, File, size, getTime());
-    curr_inode->getChildren().push_back(new_file); //push the new file to children vector of the current node
-
-    // Update the current inode's size
-    unsigned int totalSize = 0;//at first, initialize the total size with zero
-    Vector<Inode*>& children = curr_inode->getChildren();
-
-    //traverse throug all the children
-    for (size_t i = 0; i < children.size(); ++i) {
-        totalSize += children[i]->getSize();//add the size of the newly created file to its parent directory
+    if (!journal.open(journal_file, last + 1)) {
+        cout << "Could not open the journal '" << journal_file << "'." << endl;
+        return false;
     }
-
-    //set the new size 
-    curr_inode->setSize(totalSize);
-
-    // Update parent sizes
-    Inode* temp = curr_inode;
-    while (temp != nullptr) {//stops after traversing through the root directory
-        unsigned int totalSize = 0;
-        Vector<Inode*>& children = temp->getChildren();
-        for (size_t i = 0; i < children.size(); ++i) {//traverse through all the children
-            totalSize += children[i]->getSize();
+    if (applied + failed > 0) {
+        cout << "Replayed " << applied << " journal records";
+        if (failed > 0) {
+            cout << " (" << failed << " no longer applied)";
         }
-        temp->setSize(totalSize);//set the new updated size
-        temp = temp->getParent();//forward it to the parent inode
+        cout << "." << endl;
     }
+    return true;
 }
 
-//create a method to go to a specific a directory
-void VFS::cd(string path) {
-
-    //if the path is "/", it's at root
-    if (path == "/") {
-        curr_inode = root;
-        prev_inode = nullptr;
-        return;
+//create a method that redoes one journal record in the folder it was made in, without printing
+bool VFS::apply(const JournalRecord& record) {
+    if (record.type == J_RECOVER || record.type == J_PURGE) {
+        TrashItem* item = findBinItem(root, record.name);
+        if (item == nullptr) {
+            return false;
+        }
+        if (record.type == J_PURGE) {
+            purgeItem(item);
+            return true;
+        }
+        return recoverItem(item);
+    }
+    if (record.type == J_EMPTYBIN) {
+        clearBin();
+        return true;
+    }
+    if (record.type == J_SNAPSHOT) {
+        return createView(record.name, record.time) != nullptr;
+    }
+    if (record.type == J_DROP) {
+        return dropView(record.name);
     }
 
-    else if (path == "..") {  // for moving to the parent directory
-        if (curr_inode != root) {//for every directory except root
-            prev_inode = curr_inode;//set the previous node as the current node
-            curr_inode = curr_inode->getParent();//set the current node as the parent of the current node
-        } else {
-            cout << "Already at root directory." << endl;
-            
+    Inode* parent = getNode(record.path, true);
+    if (parent == nullptr || parent->getType() != Folder) {
+        return false;
+    }
+    Inode* target = parent->lookupChild(record.name);
+    switch (record.type) {
+        case J_MKDIR:
+        case J_TOUCH:
+            if (target != nullptr || nameError(parent, record.name) != nullptr) {
+                return false;
+            }
+            createChild(parent, record.name, record.type == J_MKDIR ? Folder : File, record.size, record.time);
+            return true;
+        case J_RM:
+            if (target == nullptr) {
+                return false;
+            }
+            moveToBin(parent, target);
+            return true;
+        case J_MV: {
+            Inode* folder = parent->lookupChild(record.target);
+            if (target == nullptr || folder == nullptr || target == folder || folder->getType() != Folder || folder->lookupChild(record.name) != nullptr
+                || nameError(folder, record.name) != nullptr) {
+                return false;
+            }
+            moveChild(target, folder);
+            return true;
         }
-        return;
-    } 
-
-    else if (path == "-") {  // for moving to previous working directory
-        if (prev_inode != nullptr) {//unless it reaches the root
-
-            //swap current node and previous node
-            Inode* temp = curr_inode;//create a temporary pointer and assign current node to it
-            curr_inode = prev_inode;//set the current node as the previous node
-            prev_inode = temp;//set the previous node as temp
-
-        } else {
-            cout << "No previous working directory." << endl;
-
+        case J_CP: {
+            Inode* source = getNode(record.target, true);
+            if (target != nullptr || source == nullptr || contains(source, parent) || nameError(parent, record.name) != nullptr) {
+                return false;
+            }
+            copyInto(parent, source, record.name);
+            return true;
         }
-        return;
-    } 
-
-    else if (path == "") {  // if the user just types "cd", it will take to root
-        curr_inode = root; //set the current node as root and the previous one as nullptr
-        prev_inode = nullptr;
-        return;
-
-    } 
+        case J_WRITE:
+        case J_APPEND:
+            if (target == nullptr || target->getType() != File) {
+                return false;
+            }
+            storeContents(target, record.target.data(), record.target.size(), record.type == J_APPEND);
+            return true;
+        case J_TRUNCATE:
+            if (target == nullptr || target->getType() != File) {
+                return false;
+            }
+            resizeContents(target, record.size);
+            return true;
+    }
+    return false;
+}
 
-    else if (path[0] == '/') {  // for moving to any specified path
-        Inode* target = getNode(path);//get the inode at the given path
+//create a method that writes a checkpoint: after the snapshot is renamed into place the journal can start over
+bool VFS::checkpoint() {
+    ExclusiveGuard<RWLock> guard(namespace_lock);
+    finishCheckpoint(true);
+    checkpoint_due = false;
+    if (!journal.isOpen()) {
+        cout << "No journal is open." << endl;
+        return false;
+    }
+    uint64_t bytes = journal.fileBytes();
+    if (!save(checkpoint_file)) {
+        return false;
+    }
+    if (!journal.reset()) {
+        cout << "Could not empty the journal." << endl;
+        return false;
+    }
+    cout << "Checkpoint written, " << bytes << " journal bytes compacted." << endl;
+    return true;
+}
 
-        if (target != nullptr) {//unless the given node is file or a nullptr
-            prev_inode = curr_inode;//set the previous node as the current node
-            curr_inode = target;//set the current node as the target node
-        } else {
-            //show an error message if the path cant be found
-            cout << "Path not found." << endl; 
+void VFS::checkpointCommand(string option) {
+    if (option.empty()) {
+        if (startCheckpoint()) {
+            cout << "Checkpoint started in the background." << endl;
         }
-        return;
-    } 
-
-
-    else {  // Move to specified folder
-        Inode* target = getChild(curr_inode, path);//get the children node in the path
-
-        //unless the given node is file or a nullptr
-        if (target != nullptr && target->getType() == Folder) {//if the inode is a folder
-            prev_inode = curr_inode;//set the previous node as the current node
-            curr_inode = target;//set the current node as the target node
-        } else {
-            cout << "Invalid folder or file." << endl;
+    } else if (option == "wait") {
+        if (!waitCheckpoint()) {
+            cout << "No checkpoint is being written." << endl;
         }
-        return;
+    } else if (option == "now") {
+        checkpoint();
+    } else {
+        cout << "Unknown option '" << option << "', use wait or now." << endl;
     }
 }
 
+//create a method that takes, in O(1) each, the copies a background checkpoint writes, then starts its thread
+bool VFS::startCheckpoint() {
+    ExclusiveGuard<RWLock> guard(namespace_lock);
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    checkpoint_due = false;
+    if (!journal.isOpen()) {
+        cout << "No journal is open." << endl;
+        return false;
+    }
+    if (background != nullptr) {
+        cout << "A checkpoint is being written." << endl;
+        return false;
+    }
 
-//create a method which removes the file with a given name
-void VFS::rm(string file_name) {
-    // Find the target file in the current inode's children
-    Inode* target = nullptr;
-    Vector<Inode*>& children = curr_inode->getChildren();
-    for (size_t i = 0; i < children.size(); ++i) {//traverse through all the children
-        if (children[i]->getName() == file_name) {//if the file name matches any child's name, set that child's name as the target
-            target = children[i];
-            children.erase(i);//remove that child
-            break;
+    //the same tops as save: the tree, the bin items oldest first, then the snapshots numbered 0
+    CheckpointRun* run = new CheckpointRun();
+    vector<Inode*> originals(1, root);
+    for (TrashItem* item = trash.oldest(); item != nullptr; item = item->newer) {
+        SnapshotBinItem saved = {item->id, item->deleted, ""};
+        binPath(item, saved.path);
+        originals.push_back(item->node);
+        run->items.push_back(saved);
+    }
+    for (size_t i = 0; i < views.size(); ++i) {
+        SnapshotBinItem saved = {0, views[i].created, "/.snap/" + views[i].name};
+        originals.push_back(views[i].root);
+        run->items.push_back(saved);
+    }
+    {
+        lock_guard<mutex> index(index_lock);
+        for (size_t i = 0; i < originals.size(); ++i) {
+            run->tops.push_back(clones.copy(originals[i], nullptr, originals[i]->getName()));
         }
     }
+    //the table is laid out without growing under the lock, at the size of the table before it if it was built
+    size_t entries = max<size_t>(pool.liveCount(), table.count());
+    run->table.reserve(entries + entries / 8, (entries + entries / 8) * 12);
+    run->file = checkpoint_file;
+    run->bin_next_id = trash.nextId();
+
+    //everything journaled so far is in the copies
+    journal.sync();
+    run->sequence = journal.nextSequence() - 1;
+    run->journal_bytes = journal.fileBytes();
+    run->started = start;
+    run->start_pause = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    background = run;
+    run->worker = thread(&VFS::checkpointWorker, this, run);
+    return true;
+}
 
-    if (target != nullptr) {
-
-        // Enqueue the removed file/folder to the bin
-        bin.enqueue(target);
-        bin_paths.enqueue(pwd() + "/" + file_name);//enqueue the path as well
-
-        // Update the current inode's size
-        unsigned int totalSize = 0;
-        for (size_t j = 0; j < children.size(); ++j) {//traverse through all the children
-            totalSize += children[j]->getSize();//update the child's size to the parent's size
+//create a method that lays the copies out a slice at a time, letting go of the lock between slices, then writes the table without any lock
+void VFS::checkpointWorker(CheckpointRun* run) {
+    //a copy shows the children of what it copies, and a folder still in the snapshot is materialized first
+    auto children = [this](Inode* node) -> Vector<Inode*>* {
+        Inode* shown = readThrough(node);
+        if (shown == node) {
+            materialize(node);
         }
-
-        //set the new size
-        curr_inode->setSize(totalSize);
-        // Update parent sizes
-        Inode* temp = curr_inode;
-        while (temp != nullptr) {//stops after traversing through root
-            unsigned int totalSize = 0;//initialize the size as 0
-            Vector<Inode*>& children = temp->getChildren();//store the children inodes to a vector
-            for (size_t i = 0; i < children.size(); ++i) {//traverse through all the children
-                totalSize += children[i]->getSize();
-            }
-            //set the new size
-            temp->setSize(totalSize);
-
-            //forward to the parent
-            temp = temp->getParent();
+        return &shown->children;
+    };
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    bool complete = false;
+    while (!complete && !run->cancel) {
+        //the lock is tried instead of waited for, so a command holding it exclusively can stop the walk
+        if (!namespace_lock.try_lock_shared()) {
+            this_thread::sleep_for(chrono::microseconds(CHECKPOINT_PAUSE));
+            continue;
         }
+        chrono::steady_clock::time_point slice = chrono::steady_clock::now();
+        complete = run->table.buildSlice(run->tops, children, CHECKPOINT_SLICE, run->cursor);
+        namespace_lock.unlock_shared();
+        run->longest_slice = max(run->longest_slice, chrono::duration<double>(chrono::steady_clock::now() - slice).count());
+        run->slices++;
+        if (!complete) {
+            this_thread::sleep_for(chrono::microseconds(CHECKPOINT_PAUSE));//a writer waiting for the lock gets it now
+        }
+    }
+    run->walk = chrono::duration<double>(chrono::steady_clock::now() - start).count();
 
-        cout << "File '" << file_name << "' removed and added to bin." << endl;
-    } 
-
-    else {
-        cout << "File '" << file_name << "' not found." << endl;
+    //the contents the table points at are held by the copies, so no write of a session changes them
+    if (complete) {
+        start = chrono::steady_clock::now();
+        run->saved = run->table.save(run->file, files, run->items, run->bin_next_id, run->sequence);
+        run->write = chrono::duration<double>(chrono::steady_clock::now() - start).count();
     }
+    run->done = true;
 }
 
+//create a method that waits, without the lock the worker needs, until the background checkpoint is written, then reports it
+bool VFS::waitCheckpoint() {
+    while (true) {
+        {
+            SharedGuard<RWLock> guard(namespace_lock);
+            if (background == nullptr) {
+                return false;
+            }
+            if (background->done) {
+                break;
+            }
+        }
+        this_thread::sleep_for(chrono::milliseconds(1));
+    }
+    finishCheckpoint(false);
+    return true;
+}
 
-//create a method which returns the total size of a file/folder
-void VFS::size(string path) {
-
-
-    Inode* target = getNode("/"+path);//get the node at that path
-
-    if (target == nullptr) {//show error message if the path does not exist
-        cout << "Invalid path." << endl;
+//create a method that ends the background checkpoint: its copies are freed like a purged bin item, and the journal keeps only what came after it
+void VFS::finishCheckpoint(bool cancel) {
+    ExclusiveGuard<RWLock> guard(namespace_lock);
+    CheckpointRun* run = background;
+    if (run == nullptr) {
         return;
     }
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    if (cancel) {
+        run->cancel = true;
+    }
+    run->worker.join();//a worker that is still walking stops at its next slice
+    background = nullptr;
+    for (size_t i = 0; i < run->tops.size(); ++i) {
+        purge_stack.push_back(run->tops[i]);
+    }
 
-    //if the target is folder, call the helper method to update the size
-    if (target->getType() == Folder) {
-        unsigned int totalSize = 0;
-        calculateFolderSize(target, totalSize);//call the helper method
-        cout << "Size of " << target->getName() << " and its contents: " << totalSize << " bytes" << endl;
-    } 
-    else {
-        cout << "Size of " << target->getName() << ": " << target->getSize() << " bytes" << endl;
+    uint64_t compacted = 0;
+    bool kept = true;
+    if (run->saved && journal.isOpen()) {
+        compacted = run->journal_bytes;
+        kept = journal.dropBefore(run->journal_bytes);
+    }
+    double finish_pause = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    double total = chrono::duration<double>(chrono::steady_clock::now() - run->started).count();
+    if (run->saved) {
+        cout << "Checkpoint written in the background: " << run->table.count() << " Inodes to '" << run->file << "' in " << fixed << setprecision(3) << total << " s"
+             << " (walk " << run->walk << " s in " << run->slices << " slices, longest " << run->longest_slice * 1000 << " ms; write " << run->write << " s;"
+             << " paused the sessions " << run->start_pause * 1000 << " ms to start and " << finish_pause * 1000 << " ms to finish), "
+             << compacted << " journal bytes compacted." << endl;
+        cout.unsetf(ios::fixed);
+        cout << setprecision(6);
+    } else if (run->cancel) {
+        cout << "Background checkpoint stopped." << endl;
+    } else {
+        cout << "Could not save to '" << run->file << "'." << endl;
+    }
+    if (!kept) {
+        cout << "Could not compact the journal." << endl;
     }
+    delete run;
 }
 
-//the helper method for calculating folder size
-void VFS::calculateFolderSize(Inode* folder, unsigned int& totalSize) {
-    if (folder == nullptr || folder->getType() != Folder) {//if it is not a folder or an invalid folder, return
+//create a method that appends a record for a change made in a folder and commits it; it is called with the folder still locked, so the records are in the order of the changes
+void VFS::logChange(Inode* dir, uint8_t type, const string& name, const string& target, uint64_t size, int64_t cr_time) {
+    if (!journal.isOpen()) {
         return;
     }
-
-    Vector<Inode*>& children = folder->getChildren();//store the children in a Vector
-
-    for (size_t i = 0; i < children.size(); ++i) {//traverse through all the children
-        totalSize += children[i]->getSize();//add the child's size to the parents size
-
-        if (children[i]->getType() == Folder) {//if it is a folder
-            calculateFolderSize(children[i], totalSize); // Recursively calculate sizes of subfolders
-        }
+    string path;
+    pathOf(dir, path);
+    lock_guard<mutex> guard(journal_lock);
+    journal.append(type, path, name, target, size, cr_time);
+    journal.commit();
+    if (journal.fileBytes() > CHECKPOINT_BYTES) {
+        checkpoint_due = true;//a session may hold the namespace lock shared, so the checkpoint waits for maintain
     }
 }
 
-
-
-// Show items in the bin
-void VFS::showbin() {
-    int bin_size = bin.getSize();//get the bin size
-
-    if (bin_size == 0) {//print if the bin has nothing in it
-        cout << "Bin is empty." << endl;
+//create a method that sets the sync policy and prints what the journal has done
+void VFS::journalCommand(string policy) {
+    ExclusiveGuard<RWLock> guard(namespace_lock);
+    if (policy == "always") {
+        journal.setPolicy(SYNC_ALWAYS);
+    } else if (policy == "batch") {
+        journal.setPolicy(SYNC_BATCH);
+    } else if (policy == "none") {
+        journal.setPolicy(SYNC_NONE);
+    } else if (!policy.empty()) {
+        cout << "Unknown policy '" << policy << "', use always, batch or none." << endl;
         return;
     }
+    const char* names[] = {"always", "batch", "none"};
+    cout << "Journal   : " << (journal.isOpen() ? "open" : "closed") << ", sync " << names[journal.getPolicy()] << endl;
+    cout << "Records   : " << journal.recordCount() << " in " << journal.commitCount() << " commits, " << journal.syncCount() << " syncs" << endl;
+    cout << "Size      : " << journal.fileBytes() << " bytes, next sequence " << journal.nextSequence() << endl;
+}
 
-    cout << "Items in the bin:" << endl;
+//create a method that checks a name before an Inode gets it in folder: a '/' would make it unreachable, and /.snap is where the snapshots are reached
+const char* VFS::nameError(Inode* folder, const string& name) {
+    if (name.empty() || name.find('/') != string::npos) {
+        return "Names cannot be empty or contain '/'.";
+    }
+    if (folder == root && name == ".snap") {
+        return "'.snap' is reserved at the root for the snapshots.";
+    }
+    return nullptr;
+}
 
-    //traverse through the elements
-    for (int i = 0; i < bin_size; ++i) {
-        cout << bin_paths.front_element() << endl;//print the oldest erlement
-        bin_paths.enqueue(bin_paths.dequeue()); // Displayed path moved to the end for next display
+//create a method that links a new Inode under its parent, whose lock the caller holds; every Inode of the tree is created here
+Inode* VFS::createChild(Inode* parent, const string& name, bool type, uint64_t size, int64_t cr_time) {
+    unshare(parent);
+    Inode* node;
+    {
+        lock_guard<mutex> guard(index_lock);
+        node = pool.create(name, parent, type, size, cr_time);
+        names.insert(node);
     }
+    VFS_COUNT(S_CREATED, 1);
+    parent->addChild(node);
+    propagateSize(parent, size);
+    tree_version++;
+    return node;
 }
 
-// Empty the bin
-void VFS::emptybin() {
-    while (!bin.isEmpty()) {
-        delete bin.dequeue(); // Free memory associated with the Inode
-        bin_paths.dequeue(); // Remove the path from bin_paths
+//create a method that writes to a file whose lock the caller holds: the copies of its folder are expanded first, so they keep the contents as they were, and shared contents are copied
+void VFS::storeContents(Inode* file, const char* bytes, size_t length, bool append) {
+    unshare(file->getParent());
+    uint64_t before = file->getSize();
+    uint64_t offset = append ? before : 0;
+    file->data = file->data == nullptr ? files.create() : files.own(file->data, offset);//a copy keeps only what the write does not replace
+    files.write(file->data, offset, bytes, length);
+    if (!append) {
+        files.truncate(file->data, length);
     }
+    propagateSize(file, static_cast<int64_t>(offset + length) - static_cast<int64_t>(before));
+    VFS_COUNT(S_BYTES_WRITTEN, length);
+    tree_version++;
 }
 
-//helper method to format the time
-string VFS::getTime() {
-    time_t currentTime = time(nullptr);// to get the current time from the system clock
-    tm* localTime = localtime(&currentTime);//to convert it to the local tiem
-    char formattedTime[100];//formatting the screen
+void VFS::resizeContents(Inode* file, uint64_t length) {
+    unshare(file->getParent());
+    uint64_t before = file->getSize();
+    if (file->data != nullptr) {
+        file->data = files.own(file->data, min(before, length));
+        files.truncate(file->data, length);
+    }
+    propagateSize(file, static_cast<int64_t>(length) - static_cast<int64_t>(before));
+    tree_version++;
+}
 
-    strftime(formattedTime, sizeof(formattedTime), "%Y-%m-%d %H:%M:%S", localTime);//writes in year, month, day, hour, minute, and second
-    return string(formattedTime);//return the formatted version
+template <typename F>
+void VFS::readContents(Inode* file, uint64_t offset, uint64_t length, F fn) {
+    uint64_t size = file->getSize();
+    files.read(file->data, size, offset, length, fn);
+    VFS_COUNT(S_BYTES_READ, offset < size ? min(length, size - offset) : 0);
 }
 
-// Find a file or directory
-void VFS::find(string name) {
-    // Start the search from the root
-    find_helper(root, name,"");//call the helper method
+// Get the current working directory
+string VFS::pwd(Session& s) {
+    SharedGuard<RWLock> guard(namespace_lock);
+    enter(s, false);
+    return folderPath(s);
 }
 
-//create a helper method to start finding from root
-void VFS::find_helper(Inode* ptr, string name, string currentPath) {
-    if (ptr->getName() == name) {
+//create a method that builds the path of an Inode in one buffer: the names are measured on the way up, then copied into place from the back; items in the bin have no parent
+bool VFS::pathOf(Inode* ptr, string& path) {
+    //if the path is at root, return root
+    if (ptr == root) {
+        path = "/";
+        return true;
+    }
+
+    size_t length = 0;
+    Inode* top = ptr;//the Inode below the root, or the top of a subtree outside the tree
+    for (Inode* temp = ptr; temp != nullptr && temp != root; temp = temp->getParent()) {
+        length += temp->getName().size() + 1;
+        top = temp;
+    }
+    bool view = top->getParent() == nullptr && isView(top);//the root of a snapshot is named after it
 
-        //if the given name matches, print the path
-        if (currentPath == "/Root") {
-            cout << "Found at: /" << name << endl;
-        } else {
-            cout << "Found at: " << (currentPath.size() > 6 ? currentPath.substr(6) : currentPath) << "/" << name << endl;
+    size_t end = length + (view ? 6 : 0);
+    path.resize(end);
+    if (view) {
+        path.replace(0, 6, "/.snap");
+    }
+    for (Inode* temp = ptr; temp != nullptr && temp != root; temp = temp->getParent()) {
+        const string& name = temp->getName();
+        end -= name.size();
+        path.replace(end, name.size(), name);
+        path[--end] = '/';
+    }
+    return view || top->getParent() == root;
+}
 
+// List contents of the current directory, all of them in the order they were added (a removal moves the last one into its place), or a sorted page of them
+void VFS::ls(Session& s, const string& options) {
+    SharedGuard<RWLock> guard(namespace_lock);
+    Inode* curr_inode = enter(s, false);
+    ostream& out = *s.out;
+    if (options.find_first_not_of(' ') != string::npos) {
+        ListOptions list;
+        string error;
+        if (!list.parse(options, error)) {
+            out << error << endl;
+            return;
+        }
+        bool mapped;
+        {
+            SharedGuard<SpinRWLock> folder(curr_inode->dir_lock);
+            mapped = curr_inode->lazy != nullptr && curr_inode->lazy == snapshot;
+        }
+        if (mapped) {//sorting needs the Inodes, not the mapping; a copy is read through instead
+            materialize(curr_inode);
         }
+        SharedGuard<SpinRWLock> folder(curr_inode->dir_lock);
+        listPage(readThrough(curr_inode), list, out);
+        return;
     }
-    
+    SharedGuard<SpinRWLock> folder(curr_inode->dir_lock);
 
-    Vector<Inode*>& children = ptr->getChildren();//store all the children in a vector
+    //a folder that was not materialized from the snapshot yet is listed straight from the mapping
+    if (curr_inode->lazy != nullptr && curr_inode->lazy == snapshot) {
+        snapshot->list(curr_inode->lazy_index, out);
+        return;
+    }
 
-    //traverse through all the children
-    for (int i = 0; i < children.size(); ++i) {
+    //and a copy that was not expanded yet from the folder it copies, which only changes under the exclusive lock
+    Inode* listed = readThrough(curr_inode);
+    Vector<Inode*>& children = listed->children;//store all the children in a Vector
+    VFS_COUNT(S_CHILDREN, children.size());
 
-        string newPath = currentPath == "/Root" ? "/" + ptr->getName() : currentPath + "/" + ptr->getName();
-        find_helper(children[i], name, newPath); // Recursively search in children
+    //traverse through all the children, printing "dir" or "file", the name, the creation time and the size in bytes
+    ListWriter writer(out);
+    for (size_t i = 0; i < children.size(); ++i) {
+        writer.entry(children[i]);
     }
 }
 
-//create a function to move a file to a specific folder
-void VFS::mv(string file, string folder) {
-    // Find the target file and folder in the current inode's children
-    Inode* targetFile = nullptr;
-    Inode* targetFolder = nullptr;
-    Vector<Inode*>& children = curr_inode->getChildren();//store all the children in a vector
-
-
-    //traverse through all the children
-    for (size_t i = 0; i < children.size(); ++i) {
-        if (children[i]->getName() == file) {//if file name matches with the given name, assign it to targetFile
-            targetFile = children[i];
+//create a method that lists one page of a folder: by name from its ordered index in O(log n + k), otherwise by sorting what matches
+void VFS::listPage(Inode* folder, const ListOptions& options, ostream& out) {
+    Inode* after = nullptr;
+    if (!options.after.empty()) {
+        after = folder->index.find(options.after, hashName(options.after));
+        if (after == nullptr) {
+            out << "Child with name '" << options.after << "' not found." << endl;
+            return;
         }
-        if (children[i]->getName() == folder) {//if folder name matches with the given name, assign it to targetFolder
-            targetFolder = children[i];
+    }
+    size_t limit = options.limit > 0 ? options.limit : SIZE_MAX;
+    ListWriter writer(out);
+    const OrderedIndex<Inode>* ordered = folder->ordered;
+
+    //a range of names is read straight from the index, one more entry telling whether the page is the last
+    if (options.sort == SORT_NAME && ordered != nullptr) {
+        const string& start = after != nullptr && after->getName() > options.prefix ? after->getName() : options.prefix;
+        OrderedIndex<Inode>::Cursor cursor = ordered->lowerBound(start);
+        if (after != nullptr && cursor.valid() && cursor.get() == after) {
+            cursor.next();
+        }
+        size_t listed = 0;
+        Inode* last = nullptr;
+        for (; cursor.valid() && options.matches(cursor.get()); cursor.next()) {
+            if (listed == limit) {
+                writer.line("more after '" + last->getName() + "'");
+                break;
+            }
+            last = cursor.get();
+            writer.entry(last);
+            listed++;
         }
+        VFS_COUNT(S_CHILDREN, listed);
+        return;
     }
 
-    if (targetFile != nullptr && targetFolder != nullptr) {
-        if (targetFolder->getType() == Folder) {
-            // Move the file to the specified folder
-            targetFolder->addChild(targetFile);//add it to the new folder
-            curr_inode->removeChild(file);//remove it from the current node
-
-            cout << "File '" << file << "' moved to folder '" << folder << "'." << endl;
-        } else {
-            cout << "Target '" << folder << "' is not a folder." << endl;
+    //otherwise the candidates are the prefix range of the index, or every child, and only the page is sorted
+    vector<Inode*> page;
+    if (ordered != nullptr && !options.prefix.empty()) {
+        for (OrderedIndex<Inode>::Cursor cursor = ordered->lowerBound(options.prefix); cursor.valid() && options.matches(cursor.get()); cursor.next()) {
+            if (after == nullptr || options.before(after, cursor.get())) {
+                page.push_back(cursor.get());
+            }
         }
     } else {
-        cout << "File or folder not found." << endl;
+        Vector<Inode*>& children = folder->children;
+        for (int i = 0; i < children.size(); ++i) {
+            if (options.matches(children[i]) && (after == nullptr || options.before(after, children[i]))) {
+                page.push_back(children[i]);
+            }
+        }
+        VFS_COUNT(S_CHILDREN, children.size());
     }
+    size_t listed = min(limit, page.size());
+    partial_sort(page.begin(), page.begin() + listed, page.end(), [&options](const Inode* a, const Inode* b) { return options.before(a, b); });
+    for (size_t i = 0; i < listed; ++i) {
+        writer.entry(page[i]);
+    }
+    if (listed < page.size()) {
+        writer.line("more after '" + page[listed - 1]->getName() + "'");
+    }
+}
+
+//create a method which creates a folder with a given name; only the current folder is locked
+void VFS::mkdir(Session& s, string folder_name) {
+    UpgradeGuard<RWLock> guard(namespace_lock);
+    if (hasCopies()) {//the change may expand copies anywhere in the tree
+        guard.upgrade();
+    }
+    Inode* curr_inode = enter(s);
+    ostream& out = *s.out;
+    if (viewOf(curr_inode) != nullptr) {
+        out << "Snapshots are read-only." << endl;
+        return;
+    }
+    if (const char* error = nameError(curr_inode, folder_name)) {
+        out << error << endl;
+        return;
+    }
+    materialize(curr_inode);
+    ExclusiveGuard<SpinRWLock> folder(curr_inode->dir_lock);
+
+    if (curr_inode->lookupChild(folder_name) != nullptr) {//names are unique within a folder
+        out << "'" << folder_name << "' already exists." << endl;
+        return;
+    }
+
+    //create a new folder with given node, crrrent inode as the parent node, default size 10 bytes and the creation time
+    int64_t now = getTime();
+    createChild(curr_inode, folder_name, Folder, FOLDER_SIZE, now);
+    logChange(curr_inode, J_MKDIR, folder_name, "", FOLDER_SIZE, now);
+
+    //print a message to lett the user know that the folder has been created
+    out << "Folder '" << folder_name << "' created." << endl;
+}
+
+
+//create a method that creates a file with a given name, and size; only the current folder is locked
+void VFS::touch(Session& s, string file_name, unsigned int size) {
+    ostream& out = *s.out;
+    
+    //check whether the user provides a valid name or not
+    for (char ch : file_name) {
+        // Check if the character is alphanumeric or a period
+        if (!std::isalnum(ch) && ch != '.') {
+            out<<"File names should be alphaneumeric only. Try again!"<<endl;
+            return ;
+        }
+    }
+
+    UpgradeGuard<RWLock> guard(namespace_lock);
+    if (hasCopies()) {//the change may expand copies anywhere in the tree
+        guard.upgrade();
+    }
+    Inode* curr_inode = enter(s);
+    if (viewOf(curr_inode) != nullptr) {
+        out << "Snapshots are read-only." << endl;
+        return;
+    }
+    if (const char* error = nameError(curr_inode, file_name)) {
+        out << error << endl;
+        return;
+    }
+    materialize(curr_inode);
+    ExclusiveGuard<SpinRWLock> folder(curr_inode->dir_lock);
+
+    if (curr_inode->lookupChild(file_name) != nullptr) {//names are unique within a folder
+        out << "'" << file_name << "' already exists." << endl;
+        return;
+    }
+
+    //create a new file with given information
+    int64_t now = getTime();
+    createChild(curr_inode, file_name, File, size, now);
+    logChange(curr_inode, J_TOUCH, file_name, "", size, now);
 }
 
+//create a method that writes text to a file, replacing its contents or appending to them; a file that does not exist is created first
+void VFS::writeFile(Session& s, string path, const string& text, bool append) {
+    UpgradeGuard<RWLock> guard(namespace_lock);
+    if (hasCopies()) {//the change may expand copies anywhere in the tree
+        guard.upgrade();
+    }
+    Inode* curr_inode = enter(s);
+    ostream& out = *s.out;
+
+    //the folder is resolved first, the file may still have to be created in it
+    string to = absolutePath(curr_inode, path);
+    size_t slash = to.find_last_of('/');
+    string name = to.substr(slash + 1);
+    Inode* folder = getNode(to.substr(0, slash), true);
+    if (path.empty() || name.empty() || folder == nullptr || folder->getType() != Folder) {
+        out << "Path not found: " << path << endl;
+        return;
+    }
+    if (viewOf(folder) != nullptr) {
+        out << "Snapshots are read-only." << endl;
+        return;
+    }
+    materialize(folder);
+    Inode* file;
+    {
+        SharedGuard<SpinRWLock> shared(folder->dir_lock);
+        file = folder->lookupChild(name);
+    }
+    if (file == nullptr) {
+        for (char ch : name) {
+            if (!std::isalnum(ch) && ch != '.') {
+                out << "File names should be alphaneumeric only. Try again!" << endl;
+                return;
+            }
+        }
+        if (const char* error = nameError(folder, name)) {
+            out << error << endl;
+            return;
+        }
+        ExclusiveGuard<SpinRWLock> exclusive(folder->dir_lock);
+        file = folder->lookupChild(name);
+        if (file == nullptr) {//unless another session created it in the meantime
+            int64_t now = getTime();
+            file = createChild(folder, name, File, 0, now);
+            logChange(folder, J_TOUCH, name, "", 0, now);
+        }
+    }
+    if (file->getType() != File) {
+        out << "'" << name << "' is a folder." << endl;
+        return;
+    }
+
+    ExclusiveGuard<SpinRWLock> contents(file->dir_lock);
+    storeContents(file, text.data(), text.size(), append);
+    logChange(folder, append ? J_APPEND : J_WRITE, name, text, 0, 0);
+}
 
+//create a method that prints a file from the spans of its blocks, without copying them
+void VFS::cat(Session& s, string path) {
+    SharedGuard<RWLock> guard(namespace_lock);
+    enter(s, false);
+    ostream& out = *s.out;
+    Inode* file = path.empty() ? nullptr : readNode(absolutePath(s, path), true);
+    if (file == nullptr) {
+        out << "'" << path << "' not found." << endl;
+        return;
+    }
+    if (file->getType() != File) {
+        out << "'" << path << "' is a folder." << endl;
+        return;
+    }
+
+    SharedGuard<SpinRWLock> contents(file->dir_lock);
+    char last = '\n';
+    readContents(file, 0, file->getSize(), [&out, &last](const char* from, uint64_t n) { out.write(from, n); last = from[n - 1]; });
+    if (last != '\n') {//the prompt starts on a line of its own
+        out << endl;
+    }
+}
+
+//create a method that sets the size of a file: what is after a smaller size is freed, a larger one reads as zeros
+void VFS::truncate(Session& s, string path, string length) {
+    ostream& out = *s.out;
+    char* end = nullptr;
+    unsigned long long size = strtoull(length.c_str(), &end, 10);
+    if (path.empty() || length.empty() || *end != '\0') {
+        out << "Usage: truncate file size" << endl;
+        return;
+    }
+
+    UpgradeGuard<RWLock> guard(namespace_lock);
+    if (hasCopies()) {//the change may expand copies anywhere in the tree
+        guard.upgrade();
+    }
+    Inode* file = getNode(absolutePath(enter(s), path), true);
+    if (file == nullptr) {
+        out << "'" << path << "' not found." << endl;
+        return;
+    }
+    if (file->getType() != File) {
+        out << "'" << path << "' is a folder." << endl;
+        return;
+    }
+    if (viewOf(file) != nullptr) {
+        out << "Snapshots are read-only." << endl;
+        return;
+    }
+
+    ExclusiveGuard<SpinRWLock> contents(file->dir_lock);
+    resizeContents(file, size);
+    logChange(file->getParent(), J_TRUNCATE, file->getName(), "", size, 0);
+}
+
+//create a method to go to a specific a directory
+void VFS::cd(Session& s, string path) {
+    SharedGuard<RWLock> guard(namespace_lock);
+    Inode* curr_inode = enter(s, false);//a copy is read through, cd does not expand it
+    ostream& out = *s.out;
+
+    //if the path is "/", it's at root
+    if (path == "/") {
+        setFolder(s, root);
+        s.prev_inode = nullptr;
+        return;
+    }
+
+    else if (path == "..") {  // for moving to the parent directory
+        if (!s.curr_below.empty()) {//still inside the copy, or back at it
+            size_t slash = s.curr_below.find_last_of('/');
+            setFolder(s, s.curr_inode, slash == string::npos ? "" : s.curr_below.substr(0, slash));
+        } else if (curr_inode != root) {//for every directory except root, the root of a snapshot goes back to the tree's
+            setFolder(s, curr_inode->getParent() != nullptr ? curr_inode->getParent() : root);//set the current node as the parent of the current node
+        } else {
+            out << "Already at root directory." << endl;
+            
+        }
+        return;
+    } 
+
+    else if (path == "-") {  // for moving to previous working directory
+        //unless it reaches the root, or another session removed it
+        if (s.prev_inode != nullptr && alive(s.prev_inode, s.prev_ino)) {
+
+            //swap current node and previous node
+            setFolder(s, s.prev_inode, s.prev_below);
+
+        } else {
+            out << "No previous working directory." << endl;
+
+        }
+        return;
+    } 
+
+    else if (path == "") {  // if the user just types "cd", it will take to root
+        setFolder(s, root); //set the current node as root and the previous one as nullptr
+        s.prev_inode = nullptr;
+        return;
+
+    } 
+
+    else if (path[0] == '/') {  // for moving to any specified path
+        Inode* anchor;
+        string below;
+        Inode* target = readNode(path, false, &anchor, &below);//get the inode at the given path
+
+        if (target != nullptr) {//unless the given node is file or a nullptr
+            setFolder(s, anchor, below);//set the current node as the target node
+        } else {
+            //show an error message if the path cant be found
+            out << "Path not found." << endl; 
+        }
+        return;
+    } 
 
-// Recover the oldest item from the bin
-void VFS::recover() {
-    if (bin.isEmpty()) {// if the bin is empty, print it
+
+    else {  // Move to specified folder
+        Inode* shown = readThrough(curr_inode);
+        if (shown == curr_inode) {
+            materialize(curr_inode);
+        }
+        Inode* target;
+        {
+            SharedGuard<SpinRWLock> folder(shown->dir_lock);
+            target = shown->lookupChild(path);//get the children node in the path
+        }
+        if (target == nullptr) {
+            cout << "Child '" << path << "' not found under '" << curr_inode->getName() << "'." << endl;
+        }
+
+        //unless the given node is file or a nullptr
+        if (target != nullptr && target->getType() == Folder) {//if the inode is a folder
+            if (shown != curr_inode || !s.curr_below.empty()) {//a folder inside a copy is held by the copy and the path below it
+                setFolder(s, s.curr_inode, s.curr_below.empty() ? path : s.curr_below + "/" + path);
+            } else {
+                setFolder(s, target);//set the current node as the target node
+            }
+        } else {
+            out << "Invalid folder or file." << endl;
+        }
+        return;
+    }
+}
+
+
+//create a method which removes the file with a given name; it detaches a subtree other sessions may be in, so it excludes them
+void VFS::rm(Session& s, string file_name) {
+    ExclusiveGuard<RWLock> guard(namespace_lock);
+    Inode* curr_inode = enter(s);
+    ostream& out = *s.out;
+    if (viewOf(curr_inode) != nullptr) {
+        out << "Snapshots are read-only." << endl;
+        return;
+    }
+    // Find the target file in the current inode's child index
+    Inode* target = curr_inode->lookupChild(file_name);
+
+    if (target != nullptr) {
+        moveToBin(curr_inode, target);
+        logChange(curr_inode, J_RM, file_name, "", 0, 0);
+
+        out << "File '" << file_name << "' removed and added to bin." << endl;
+    } 
+
+    else {
+        out << "File '" << file_name << "' not found." << endl;
+    }
+}
+
+
+//create a method which returns the total size of a file/folder
+void VFS::size(Session& s, string path) {
+    SharedGuard<RWLock> guard(namespace_lock);
+    ostream& out = *s.out;
+
+    enter(s, false);
+    Inode* target = readNode(absolutePath(s, path), false);//get the node at that path, from the current folder like cd
+
+    if (target == nullptr) {//show error message if the path does not exist
+        out << "Invalid path." << endl;
+        return;
+    }
+
+    //the size of a folder is maintained as the aggregate of its contents, so no traversal is needed
+    if (target->getType() == Folder) {
+        out << "Size of " << target->getName() << " and its contents: " << target->getSize() << " bytes" << endl;
+    } 
+    else {
+        out << "Size of " << target->getName() << ": " << target->getSize() << " bytes" << endl;
+    }
+}
+
+// Show items in the bin
+void VFS::showbin() {
+    SharedGuard<RWLock> guard(namespace_lock);
+    if (trash.isEmpty()) {//print if the bin has nothing in it
         cout << "Bin is empty." << endl;
         return;
     }
 
-    Inode* recoveredItem = bin.dequeue(); // Get the oldest item from bin
-    string recoveredPath = bin_paths.dequeue(); // Get its path
+    cout << "Items in the bin: " << trash.size() << ", " << trash.bytes() << " bytes" << endl;
+
+    //traverse the items from the oldest to the newest
+    string path;
+    for (TrashItem* item = trash.oldest(); item != nullptr; item = item->newer) {
+        binPath(item, path);
+        cout << setw(6) << item->id << "  " << formatTime(item->deleted) << "  " << setw(10) << item->node->getSize() << " bytes  " << path << endl;
+    }
+}
+
+// Empty the bin
+void VFS::emptybin() {
+    ExclusiveGuard<RWLock> guard(namespace_lock);
+    clearBin();
+    logChange(root, J_EMPTYBIN, "", "", 0, 0);
+}
+
+//create a method that purges every item; the Inodes are freed a share at a time after the following commands
+void VFS::clearBin() {
+    while (!trash.isEmpty()) {
+        purgeItem(trash.oldest());
+    }
+}
+
+//create a method that sets the bin limits and prints what the bin holds
+void VFS::binlimit(string bytes, string seconds) {
+    ExclusiveGuard<RWLock> guard(namespace_lock);
+    if (!bytes.empty()) {
+        bin_max_bytes = stoull(bytes);
+    }
+    if (!seconds.empty()) {
+        bin_max_age = stoll(seconds);
+    }
+    cout << "Bin limits : " << bin_max_bytes << " bytes, " << bin_max_age << " seconds" << endl;
+    cout << "Bin        : " << trash.size() << " items, " << trash.bytes() << " bytes, next number " << trash.nextId() << endl;
+    cout << "Purging    : " << purge_stack.size() << " Inodes and subtrees waiting to be freed" << endl;
+}
+
+//create a method that purges the oldest items while the bin is over a limit, journaling each purge, then frees a share of the purged Inodes
+void VFS::maintain() {
+    int64_t now = getTime();
+    {
+        //the sessions are only held up when there is something to do
+        SharedGuard<RWLock> guard(namespace_lock);
+        bool over = !trash.isEmpty() && (trash.bytes() > bin_max_bytes || now - trash.oldest()->deleted > bin_max_age);
+        bool checkpointing = background != nullptr ? background->done.load() : checkpoint_due.load();
+        if (!over && purge_stack.empty() && !checkpointing) {
+            return;
+        }
+    }
+    ExclusiveGuard<RWLock> guard(namespace_lock);
+    if (background != nullptr && background->done) {
+        finishCheckpoint(false);
+    }
+    if (checkpoint_due && background == nullptr) {//written in the background, so the sessions go on meanwhile
+        startCheckpoint();
+    }
+    bool purged = false;
+    while (!trash.isEmpty() && (trash.bytes() > bin_max_bytes || now - trash.oldest()->deleted > bin_max_age)) {
+        TrashItem* item = trash.oldest();
+        if (journal.isOpen()) {
+            journal.append(J_PURGE, "/", to_string(item->id), "", 0, 0);
+        }
+        purgeItem(item);
+        purged = true;
+    }
+    if (purged && journal.isOpen()) {
+        journal.commit();//one write for all the purges
+    }
+    purgeStep(PURGE_BUDGET);
+}
+
+//helper method to get the time, it is only formatted when it is printed
+int64_t VFS::getTime() {
+    return static_cast<int64_t>(time(nullptr));// to get the current time from the system clock
+}
+
+// Find a file or directory through the name index, building paths only for the hits
+void VFS::find(Session& s, string name) {
+    if (NamePattern::isWildcard(name)) {
+        findPattern(s, name, false);
+        return;
+    }
+    SharedGuard<RWLock> guard(namespace_lock);
+
+    //the hits are copied out of the indexes, whose lock other sessions' mkdir and touch need
+    vector<Inode*> nodes;
+    vector<pair<uint32_t, pair<Inode*, uint32_t> > > mapped;//snapshot entry, the lazy Inode holding it and its entry
+    {
+        lock_guard<mutex> index(index_lock);
+        Vector<Inode*>* hits = names.find(name);
+        for (int i = 0; hits != nullptr && i < hits->size(); ++i) {
+            nodes.push_back((*hits)[i]);
+        }
+
+        //names in the part of the tree that is still mapped are found in the snapshot's own index
+        if (snapshot != nullptr) {
+            vector<uint32_t> entries;
+            snapshot->lookupName(name, entries);
+            vector<pair<Inode*, uint32_t> > holders;
+            for (size_t i = 0; i < entries.size(); ++i) {
+                holders.clear();
+                snapshot->lazyHolders(entries[i], holders);
+                for (size_t k = 0; k < holders.size(); ++k) {
+                    mapped.push_back(make_pair(entries[i], holders[k]));
+                }
+            }
+        }
+    }
 
-    // Try to find the parent Inode where the recovered item should be added
-    size_t lastSlash = recoveredPath.find_last_of("/");
-    string parentPath = recoveredPath.substr(0, lastSlash);
-    Inode* parent = getNode(parentPath);
+    //a hit also shows inside every copy of one of its folders that was not expanded yet
+    vector<string> found;
+    string path;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        if (pathOf(nodes[i], path)) {//not in the bin
+            found.push_back(path);
+        }
+        clonePaths(nodes[i], "", found);
+    }
+    for (size_t i = 0; i < mapped.size(); ++i) {
+        Inode* holder = mapped[i].second.first;
+        string below = snapshot->relativePath(mapped[i].first, mapped[i].second.second);
+        if (pathOf(holder, path)) {
+            found.push_back((holder == root ? "" : path) + below);
+        }
+        clonePaths(holder, below, found);
+    }
 
+    //only the paths in the tree, or in the snapshot the current folder is in
+    enter(s, false);
+    Inode* view = viewOf(s.curr_inode);//the Inode the session holds is in the same tree as its folder
+    string scope = "/.snap/";
+    if (view != nullptr) {
+        pathOf(view, scope);
+        scope += '/';
+    }
+    sort(found.begin(), found.end());
+    for (size_t i = 0; i < found.size(); ++i) {
+        if ((found[i].compare(0, scope.size(), scope) == 0) == (view != nullptr)) {
+            *s.out << "Found at: " << found[i] << endl;
+        }
+    }
+}
+
+//a piece of a pattern search: the subtree of an Inode, or a range of entries still in the snapshot
+struct FindTask
+{
+    Inode* node;            //the subtree to search, nullptr for a range
+    uint32_t first, last;   //the range of snapshot entries
+    uint32_t anchor;        //snapshot entry of the lazy Inode the range belongs to
+    string path;            //path of node's parent, or of the lazy Inode for a range
+};
+
+//create a method that searches the tree on a work-stealing pool; every worker walks its subtrees with an explicit stack
+void VFS::findPattern(Session& s, const string& pattern, bool is_regex) {
+    SharedGuard<RWLock> guard(namespace_lock);
+    const uint32_t RANGE = 1 << 16;     //snapshot entries per range task
+    const size_t SPILL = 4;             //a worker with fewer queued tasks hands out subfolders
+    NamePattern matcher(pattern, is_regex);
+    WorkStealingPool<FindTask> workers(find_threads);
+    vector<vector<string> > found(workers.size());//one result buffer per worker, merged at the end
+
+    //only a folder with something in it is worth a task of its own
+    auto hasChildren = [](Inode* folder) {
+        SharedGuard<SpinRWLock> shared(folder->dir_lock);
+        return folder->children.size() > 0 || folder->isLazy();
+    };
+
+    //the tree, or the snapshot the current folder is in
+    enter(s, false);
+    Inode* view = viewOf(s.curr_inode);
+    FindTask start = {view != nullptr ? view : root, 0, 0, 0, view != nullptr ? "/.snap" : ""};
+    workers.push(0, start);
+    workers.run([&](FindTask& task, unsigned w) {
+        if (task.node == nullptr) {
+            vector<uint32_t> hits;
+            snapshot->matchRange(task.first, task.last, matcher, hits);
+            for (size_t i = 0; i < hits.size(); ++i) {
+                found[w].push_back(task.path + snapshot->relativePath(hits[i], task.anchor));
+            }
+            return;
+        }
 
+        vector<pair<Inode*, size_t> > stack;//the tree is only read, so the children are used without materializing
+        string path = task.path;
+        stack.push_back(make_pair(task.node, path.size()));
+        while (!stack.empty()) {
+            Inode* node = stack.back().first;
+            path.resize(stack.back().second);
+            stack.pop_back();
+
+            if (node != root) {
+                path += '/';
+                path += node->getName();
+                if (node != view && matcher.match(node->getName())) {
+                    found[w].push_back(path);
+                }
+            }
+            if (node->getType() != Folder) {
+                continue;
+            }
+            SharedGuard<SpinRWLock> folder(node->dir_lock);//other sessions may be adding children
+
+            //a lazy folder is searched in the mapping, its range cut into tasks
+            if (node->lazy != nullptr && node->lazy == snapshot) {
+                uint32_t last = snapshot->subtreeEnd(node->lazy_index);
+                for (uint32_t first = node->lazy_index + 1; first < last; first += RANGE) {
+                    FindTask range = {nullptr, first, min(last, first + RANGE), node->lazy_index, path};
+                    workers.push(w, range);
+                }
+                continue;
+            }
 
+            //a copy that was not expanded yet is searched in the folder it copies, under its own path
+            Vector<Inode*>& children = readThrough(node)->children;
+            size_t length = path.size();
+            VFS_COUNT(S_CHILDREN, children.size());
+            for (int i = children.size() - 1; i >= 0; --i) {
+                Inode* child = children[i];
+                if (child->getType() == Folder && workers.queued(w) < SPILL && hasChildren(child)) {
+                    FindTask sub = {child, 0, 0, 0, path};
+                    workers.push(w, sub);
+                } else {
+                    stack.push_back(make_pair(child, length));
+                }
+            }
+        }
+    });
+
+    vector<string> all;
+    for (size_t w = 0; w < found.size(); ++w) {
+        all.insert(all.end(), found[w].begin(), found[w].end());
+    }
+    sort(all.begin(), all.end());
+    for (size_t i = 0; i < all.size(); ++i) {
+        *s.out << "Found at: " << all[i] << endl;
+    }
+}
+
+void VFS::setFindThreads(unsigned threads) {
+    find_threads = threads;
+}
+
+//create a helper method that searches the subtree of ptr with walkTree; currentPath is the path of ptr's parent
+void VFS::find_helper(Inode* ptr, const string& name, const string& currentPath) {
+    string path = currentPath;//one buffer: a name is appended when its Inode is entered and cut off when it is left
+    walkTree(ptr, [&](Inode* node) -> Vector<Inode*>* {
+        if (node != root) {
+            path += '/';
+            path += node->getName();
+            if (node->getName() == name) {//if the given name matches, print the path
+                cout << "Found at: " << path << endl;
+            }
+        }
+
+        //the part of the tree still in the snapshot is searched in the mapping
+        if (node->lazy != nullptr && node->lazy == snapshot) {
+            vector<uint32_t> hits;
+            snapshot->findName(node->lazy_index, name, hits);
+            for (size_t i = 0; i < hits.size(); ++i) {
+                cout << "Found at: " << path << snapshot->relativePath(hits[i], node->lazy_index) << endl;
+            }
+            return nullptr;
+        }
+        return &readThrough(node)->children;//a copy shows those of what it copies
+    }, [&](Inode* node) {
+        if (node != root) {
+            path.resize(path.size() - node->getName().size() - 1);
+        }
+    });
+}
 
-    if (parent != nullptr && parent->getType() == Folder) {
-        parent->addChild(recoveredItem); // Add the recovered item to the parent Inode
+//create a function to move a file to a specific folder; it changes a parent chain, so it excludes the other sessions
+void VFS::mv(Session& s, string file, string folder) {
+    ExclusiveGuard<RWLock> guard(namespace_lock);
+    Inode* curr_inode = enter(s);
+    ostream& out = *s.out;
+    if (viewOf(curr_inode) != nullptr) {
+        out << "Snapshots are read-only." << endl;
+        return;
+    }
+    // Find the target file and folder in the current inode's child index
+    Inode* targetFile = curr_inode->lookupChild(file);
+    Inode* targetFolder = curr_inode->lookupChild(folder);
+
+    if (targetFile != nullptr && targetFolder != nullptr) {
+        if (targetFile == targetFolder) {
+            out << "Cannot move '" << file << "' into itself." << endl;
+        } else if (targetFolder->lookupChild(file) != nullptr) {
+            out << "'" << file << "' already exists in '" << folder << "'." << endl;
+        } else if (const char* error = nameError(targetFolder, file)) {
+            out << error << endl;
+        } else if (targetFolder->getType() == Folder) {
+            // Move the file to the specified folder
+            moveChild(targetFile, targetFolder);
+            logChange(curr_inode, J_MV, file, folder, 0, 0);
+
+            out << "File '" << file << "' moved to folder '" << folder << "'." << endl;
+        } else {
+            out << "Target '" << folder << "' is not a folder." << endl;
+        }
     } else {
-        cout << "Could not restore item to its original position." << endl;
+        out << "File or folder not found." << endl;
     }
+}
 
 
-    // Update the current inode's size
-    unsigned int totalSize = 0;//at first, initialize the total size with zero
-    Vector<Inode*>& children = curr_inode->getChildren();
 
-    //traverse throug all the children
-    for (size_t i = 0; i < children.size(); ++i) {
-        totalSize += children[i]->getSize();//add the size of the newly created file to its parent directory
+// Recover the oldest item from the bin, or the item with the given number or original path
+void VFS::recover(Session& s, string item) {
+    ExclusiveGuard<RWLock> guard(namespace_lock);
+    ostream& out = *s.out;
+    if (trash.isEmpty()) {// if the bin is empty, print it
+        out << "Bin is empty." << endl;
+        return;
+    }
+
+    TrashItem* found = findBinItem(enter(s), item);
+    if (found == nullptr) {
+        out << "No item '" << item << "' in the bin." << endl;
+        return;
+    }
+
+    //a failed recover leaves the bin as it was, so only a successful one is journaled
+    uint64_t id = found->id;
+    if (!recoverItem(found)) {
+        out << "Could not restore item to its original position." << endl;
+        return;
+    }
+    logChange(root, J_RECOVER, to_string(id), "", 0, 0);
+}
+
+//create a method that copies a file, or a folder and its subtree; the copy is one Inode that shares the subtree until one side changes
+void VFS::cp(Session& s, string source, string destination, bool recursive) {
+    ExclusiveGuard<RWLock> guard(namespace_lock);
+    Inode* curr_inode = enter(s);
+    ostream& out = *s.out;
+    if (source.empty() || destination.empty()) {
+        out << "Usage: cp [-r] source destination" << endl;
+        return;
+    }
+
+    //the source is only read, so a copy it is in is read through; its path is built from where it really is
+    Inode* anchor;
+    string from;
+    Inode* target = readNode(absolutePath(curr_inode, source), true, &anchor, &from);
+    if (target == nullptr) {
+        out << "'" << source << "' not found." << endl;
+        return;
+    }
+    if (target->getType() == Folder && !recursive) {
+        out << "'" << source << "' is a folder, use cp -r." << endl;
+        return;
+    }
+
+    //into an existing folder under the same name, otherwise under the last name of the destination
+    string to = absolutePath(curr_inode, destination);
+    Inode* folder = getNode(to, true);
+    string name = target->getName();
+    if (folder == nullptr || folder->getType() != Folder) {
+        size_t slash = to.find_last_of('/');
+        name = to.substr(slash + 1);
+        folder = getNode(to.substr(0, slash), true);
+        if (folder == nullptr || folder->getType() != Folder || name.empty()) {
+            out << "Path not found: " << destination << endl;
+            return;
+        }
+    }
+    string into, below = from;
+    pathOf(anchor, from);
+    if (!below.empty()) {
+        from += (from == "/" ? "" : "/") + below;
+    }
+    pathOf(folder, into);
+    if (from == "/" || into == from || into.compare(0, from.size() + 1, from + "/") == 0) {
+        out << "Cannot copy '" << source << "' into itself." << endl;
+        return;
+    }
+    if (viewOf(folder) != nullptr) {//copying out of a snapshot is how it is restored from
+        out << "Snapshots are read-only." << endl;
+        return;
+    }
+    if (folder->lookupChild(name) != nullptr) {//names are unique within a folder
+        out << "'" << name << "' already exists." << endl;
+        return;
+    }
+    if (const char* error = nameError(folder, name)) {
+        out << error << endl;
+        return;
+    }
+
+    string copied;
+    pathOf(copyInto(folder, target, name), copied);
+    logChange(folder, J_CP, name, from, 0, 0);
+    out << "Copied '" << from << "' to '" << copied << "'." << endl;
+}
+
+//create a method that detaches an Inode and adds it to the bin with a handle to its parent, through which its path is read
+void VFS::moveToBin(Inode* parent, Inode* target) {
+    unshare(parent);
+    freezePaths(target);//the items removed from inside target lose the path they are read through
+    parent->removeChild(target->getName());//detach it from its parent
+    target->parent = nullptr;//it stays in the name index, but find skips Inodes that are not in the tree
+    parent->generation = target->generation = ++generation_clock;//cached paths through either are stale
+    trash.add(target, parent, "", getTime());
+    countHolds(parent, 1);
+    VFS_COUNT(S_BIN_ADDED, 1);
+
+    // Subtract the size of the removed item from the parent and its ancestors
+    propagateSize(parent, -static_cast<int64_t>(target->getSize()));
+    tree_version++;
+}
+
+//create a method that moves an Inode under another folder, moving its size from the old ancestors to the new ones
+void VFS::moveChild(Inode* target, Inode* folder) {
+    Inode* parent = target->getParent();
+    unshare(parent);
+    unshare(folder);
+    freezePaths(target);//the paths through target change
+    parent->generation = folder->generation = target->generation = ++generation_clock;
+    parent->removeChild(target->getName());//remove it from the current node
+    propagateSize(parent, -static_cast<int64_t>(target->getSize()));//the old ancestors lose its size
+    folder->addChild(target);//add it to the new folder
+    target->parent = folder;
+    rebase(target, folder->depth + 1);
+    propagateSize(folder, target->getSize());//and the new ancestors gain it
+    tree_version++;
+}
+
+//create a method that gives the original path of a bin item: written into it, or its parent's path and its name
+void VFS::binPath(TrashItem* item, string& path) {
+    if (!item->path.empty()) {
+        path = item->path;
+        return;
+    }
+    pathOf(item->parent, path);
+    if (item->parent == root) {
+        path.clear();
+    }
+    path += '/';
+    path += item->node->getName();
+}
+
+//create a method that writes the paths of the bin items read through top or a folder below it, visiting only the folders that hold some
+void VFS::freezePaths(Inode* top) {
+    if (top->bin_holds == 0) {
+        return;
+    }
+    uint32_t frozen = top->bin_holds;
+    string path;
+    pathOf(top, path);
+    if (top == root) {
+        path.clear();
+    }
+    vector<TrashItem*> held;
+    walkTree(top, [&](Inode* node) -> Vector<Inode*>* {
+        if (node->bin_holds == 0) {//nothing was removed from here or below
+            return nullptr;
+        }
+        if (node != top) {
+            path += '/';
+            path += node->getName();
+        }
+        held.clear();
+        trash.heldBy(node, held);
+        for (size_t i = 0; i < held.size(); ++i) {
+            trash.freeze(held[i], path + "/" + held[i]->node->getName());
+        }
+        return &node->children;//the Inodes that were removed from were materialized
+    }, [&](Inode* node) {
+        if (node->bin_holds > 0) {
+            if (node != top) {
+                path.resize(path.size() - node->getName().size() - 1);
+            }
+            node->bin_holds = 0;
+        }
+    });
+    countHolds(top->getParent(), -static_cast<int64_t>(frozen));
+}
+
+//create a method that counts a bin item in the folder it was removed from and every ancestor, so that freezePaths finds it
+void VFS::countHolds(Inode* folder, int64_t delta) {
+    for (; folder != nullptr; folder = folder->getParent()) {
+        folder->bin_holds += delta;
+    }
+}
+
+//create a method that renumbers the depths of a subtree attached at another depth than before; the children that are not Inodes yet get theirs when they are created
+void VFS::rebase(Inode* top, uint32_t depth) {
+    if (top->depth == depth) {
+        return;
+    }
+    top->depth = depth;
+    walkTree(top, [&](Inode* node) -> Vector<Inode*>* {
+        if (node != top) {
+            node->depth = node->getParent()->depth + 1;
+        }
+        return node->getType() == Folder ? &node->children : nullptr;
+    });
+}
+
+//create a method that links a copy of source under folder, whose copies are expanded first as for any other change to it
+Inode* VFS::copyInto(Inode* folder, Inode* source, const string& name) {
+    unshare(folder);
+    Inode* node;
+    {
+        lock_guard<mutex> guard(index_lock);
+        node = clones.copy(source, folder, name);
+    }
+    VFS_COUNT(S_CREATED, 1);
+    folder->addChild(node);
+    propagateSize(folder, node->getSize());
+    tree_version++;
+    return node;
+}
+
+//create a method that expands, from the root down, every copy of folder and of its ancestors; a copy then holds its own Inodes for what the change would alter
+void VFS::unshare(Inode* folder) {
+    if (!hasCopies()) {
+        return;
+    }
+    vector<Inode*> chain;
+    for (Inode* node = folder; node != nullptr; node = node->getParent()) {
+        chain.push_back(node);
+    }
+
+    //expanding a copy of an ancestor adds a copy of the next folder down, which is expanded in turn
+    vector<Inode*> copies;
+    for (int i = chain.size() - 1; i >= 0; --i) {
+        copies.clear();
+        {
+            lock_guard<mutex> index(index_lock);
+            clones.copiesOf(chain[i], copies);
+        }
+        for (size_t k = 0; k < copies.size(); ++k) {
+            materialize(copies[k]);
+        }
+    }
+}
+
+bool VFS::hasCopies() {
+    lock_guard<mutex> index(index_lock);
+    return clones.size() > 0;
+}
+
+//create a method that returns the folder whose children a copy shows; it is always materialized
+Inode* VFS::readThrough(Inode* folder) {
+    if (folder->lazy == nullptr || folder->lazy == snapshot) {
+        return folder;
+    }
+    lock_guard<mutex> index(index_lock);
+    Inode* origin = clones.origin(folder);
+    return origin != nullptr ? origin : folder;
+}
+
+//create a method that adds the paths at which node (and the path below it) shows inside the copies of its ancestors, which may be inside copies in turn
+void VFS::clonePaths(Inode* node, const string& below, vector<string>& found) {
+    if (!hasCopies()) {
+        return;
+    }
+    string path;
+    vector<Inode*> copies;
+    vector<Inode*> chain;//the Inodes from node up to folder
+    for (Inode* folder = node; folder->getParent() != nullptr; folder = folder->getParent()) {
+        chain.push_back(folder);
+        copies.clear();
+        {
+            lock_guard<mutex> index(index_lock);
+            clones.copiesOf(folder->getParent(), copies);
+        }
+        if (copies.empty()) {
+            continue;
+        }
+        //the path from the copied folder down is built only at the levels that have copies
+        string relative;
+        for (size_t k = chain.size(); k-- > 0; ) {
+            relative += '/';
+            relative += chain[k]->getName();
+        }
+        relative += below;
+        for (size_t i = 0; i < copies.size(); ++i) {
+            if (pathOf(copies[i], path)) {//a copy in the bin may still be inside a copy
+                found.push_back(path + relative);
+            }
+            clonePaths(copies[i], relative, found);
+        }
+    }
+}
+
+bool VFS::contains(Inode* folder, Inode* node) {
+    //only the ancestor at the depth of folder can be folder
+    for (; node != nullptr && node->depth > folder->depth; node = node->getParent()) {
+    }
+    return node == folder;
+}
+
+string VFS::absolutePath(Inode* dir, const string& path) {
+    if (!path.empty() && path[0] == '/') {
+        return path;
+    }
+    string base;
+    pathOf(dir, base);
+    return (dir == root ? "" : base) + "/" + path;
+}
+
+string VFS::absolutePath(Session& s, const string& path) {
+    if (!path.empty() && path[0] == '/') {
+        return path;
+    }
+    string base = folderPath(s);
+    return (base == "/" ? "" : base) + "/" + path;
+}
+
+//create a method that returns the path of the Inode a session holds and of the part of the path inside a copy after it
+string VFS::folderPath(Session& s) {
+    string path;
+    pathOf(s.curr_inode, path);
+    if (!s.curr_below.empty()) {
+        path += (path == "/" ? "" : "/") + s.curr_below;
+    }
+    return path;
+}
+
+//create a method that puts a bin item back under its original parent, through the handle while the parent is still the same Inode in the tree
+bool VFS::recoverItem(TrashItem* item) {
+    //a slot that was freed, or reused by another Inode, fails the number check, and then the path is resolved instead
+    Inode* parent = item->parent;
+    if (parent == nullptr || !pool.isLive(parent) || parent->getIno() != item->parent_ino || !attached(parent)) {
+        size_t lastSlash = item->path.find_last_of("/");
+        parent = getNode(item->path.substr(0, lastSlash), true);
     }
 
-    //set the new size 
-    curr_inode->setSize(totalSize);
+    Inode* recoveredItem = item->node;
+    if (parent == nullptr || parent->getType() != Folder || parent->lookupChild(recoveredItem->getName()) != nullptr
+        || nameError(parent, recoveredItem->getName()) != nullptr) {
+        return false;//it stays in the bin
+    }
+    unshare(parent);
+    if (item->path.empty()) {//its parent no longer holds it
+        countHolds(item->parent, -1);
+    }
+    trash.remove(item);
+    parent->addChild(recoveredItem);
+    recoveredItem->parent = parent; // Add the recovered item to the parent Inode
+    rebase(recoveredItem, parent->depth + 1);
+    parent->generation = recoveredItem->generation = ++generation_clock;
+
+    // Add the size of the recovered item back to its parent and the parent's ancestors
+    propagateSize(parent, recoveredItem->getSize());
+    tree_version++;
+    return true;
+}
+
+//create a method that picks a bin item by number, by original path (relative ones start at dir), or the oldest one
+TrashItem* VFS::findBinItem(Inode* dir, const string& key) {
+    if (key.empty()) {
+        return trash.oldest();
+    }
+    if (key.find_first_not_of("0123456789") == string::npos) {
+        return trash.find(strtoull(key.c_str(), nullptr, 10));
+    }
+    TrashItem* written = trash.hasWritten() ? trash.findPath(absolutePath(dir, key)) : nullptr;
+
+    //the items read through their parent are found in the folder the key leads to, dir itself for a name
+    size_t slash = key.find_last_of('/');
+    Inode* parent = dir;
+    if (slash != string::npos) {
+        string folder = absolutePath(dir, key.substr(0, slash));
+        parent = getNode(folder.empty() ? "/" : folder, true);
+    }
+    TrashItem* held = parent != nullptr ? trash.findIn(parent, key.substr(slash + 1)) : nullptr;
+    if (held == nullptr || (written != nullptr && written->id > held->id)) {
+        return written;
+    }
+    return held;
+}
+
+//create a method that checks that an Inode has not been removed with one of its ancestors; purgeStep cuts the chains of what it frees
+bool VFS::attached(Inode* ptr) {
+    while (ptr != nullptr && ptr != root && ptr->getParent() != nullptr) {
+        ptr = ptr->getParent();
+    }
+    return ptr != nullptr && (ptr == root || isView(ptr));
+}
+
+//create a method that checks a handle (pointer and Inode number) of a session; a recycled slot has another number
+bool VFS::alive(Inode* node, uint64_t ino) {
+    {
+        lock_guard<mutex> index(index_lock);
+        if (!pool.isLive(node)) {
+            return false;
+        }
+    }
+    return node->getIno() == ino && attached(node);
+}
+
+//create a method that returns the current folder of a session, called with the namespace lock held; a folder inside a copy is expanded to, or only read through the copy
+Inode* VFS::enter(Session& s, bool expand) {
+    if (s.curr_inode == nullptr || s.mount_epoch != mount_epoch) {//first command, or the tree was replaced
+        s.curr_inode = root;
+        s.curr_ino = root->getIno();
+        s.curr_below.clear();
+        s.prev_inode = nullptr;
+        s.mount_epoch = mount_epoch;
+    } else if (s.curr_inode != root && !alive(s.curr_inode, s.curr_ino)) {
+        *s.out << "The current folder was removed, back at /." << endl;
+        s.prev_inode = nullptr;
+        s.curr_inode = root;
+        s.curr_ino = root->getIno();
+        s.curr_below.clear();
+    }
+    if (s.curr_below.empty()) {
+        return s.curr_inode;
+    }
+
+    //what the copy shows is followed from the copy again, since part of it may have been expanded since
+    Inode* anchor;
+    string below;
+    Inode* folder = walk(s.curr_inode, s.curr_below.data(), 0, s.curr_below.size(), true, expand, &anchor, &below);
+    if (folder == nullptr) {
+        *s.out << "The current folder was removed, back at /." << endl;
+        s.prev_inode = nullptr;
+        s.curr_inode = root;
+        s.curr_ino = root->getIno();
+        s.curr_below.clear();
+        return root;
+    }
+    s.curr_inode = anchor;
+    s.curr_ino = anchor->getIno();
+    s.curr_below = below;
+    return folder;
+}
+
+void VFS::setFolder(Session& s, Inode* folder, string below) {
+    s.prev_inode = s.curr_inode;
+    s.prev_ino = s.curr_ino;
+    s.prev_below = s.curr_below;
+    s.curr_inode = folder;
+    s.curr_ino = folder->getIno();
+    s.curr_below = below;
+}
+
+//create a method that creates the children of a lazy folder once, so that afterwards it can be read under its shared lock
+void VFS::materialize(Inode* folder) {
+    bool lazy;
+    {
+        SharedGuard<SpinRWLock> shared(folder->dir_lock);
+        lazy = folder->isLazy();
+    }
+    if (lazy) {
+        ExclusiveGuard<SpinRWLock> exclusive(folder->dir_lock);
+        lock_guard<mutex> index(index_lock);//expanding allocates Inodes and indexes them
+        folder->ensureChildren();
+    }
+}
+
+//create a method that adds a size difference to an Inode and every ancestor up to the root
+void VFS::propagateSize(Inode* ptr, int64_t delta) {
+    if (delta == 0) {//nothing to add, so the chain is not walked
+        return;
+    }
+    uint64_t steps = 0;
+    while (ptr != nullptr) {//stops after updating the root directory
+        ptr->addSize(delta);
+        ptr = ptr->getParent();//forward it to the parent inode
+        steps++;
+    }
+    VFS_COUNT(S_SIZE_STEPS, steps);
+}
+
+//create a method that takes an item out of the bin and queues its subtree for freeing
+void VFS::purgeItem(TrashItem* item) {
+    if (dentries.size() > 0) {
+        dentries.clear();//no cached path may point at a slot that will be recycled
+    }
+    if (item->path.empty()) {
+        countHolds(item->parent, -1);
+    }
+    purge_stack.push_back(trash.remove(item));
+    VFS_COUNT(S_BIN_PURGED, 1);
+}
+
+//create a method that frees purged Inodes without recursion, the children of a freed Inode waiting on the stack for a later step
+size_t VFS::purgeStep(size_t budget) {
+    size_t freed = 0;
+    vector<Inode*>& stack = purge_stack;//Inodes whose children still have to be visited
+    while (!stack.empty() && freed < budget) {
+        Inode* node = stack.back();
+        stack.pop_back();
+        //the copies of a folder keep what it holds, so they are expanded before it goes
+        if (clones.size() > 0) {
+            vector<Inode*> copies;
+            clones.copiesOf(node, copies);
+            for (size_t i = 0; i < copies.size(); ++i) {
+                copies[i]->ensureChildren();
+            }
+        }
+        if (!node->isLazy()) {//children that were never materialized need no freeing
+            Vector<Inode*>& children = node->children;
+            VFS_COUNT(S_CHILDREN, children.size());
+            for (int i = 0; i < children.size(); ++i) {
+                children[i]->parent = nullptr;//a session handle to a child must not reach the freed node
+                stack.push_back(children[i]);
+            }
+        } else if (node->lazy == snapshot) {
+            snapshot->forget(node);
+        } else {
+            clones.forget(node);
+        }
+        if (node->data != nullptr) {//the contents go with the last Inode holding them
+            files.release(node->data);
+        }
+        names.erase(node);
+        pool.destroy(node);//the children were saved on the stack, so the node can go
+        freed++;
+    }
+    VFS_COUNT(S_FREED, freed);
+    return freed;
+}
+
+//create a method that prints how full the Inode arena is
+void VFS::arena() {
+    ExclusiveGuard<RWLock> guard(namespace_lock);
+    cout << "Inodes live: " << pool.liveCount() << endl;
+    cout << "Free slots : " << pool.freeCount() << endl;
+    cout << "Slots      : " << pool.slotCount() << " in " << pool.slabCount() << " slabs (" << pool.bytesReserved() / 1024 << " KB)" << endl;
+    cout << "Created    : " << pool.createdCount() << ", destroyed: " << pool.destroyedCount() << endl;
+}
+
+void VFS::dcache() {
+    lock_guard<mutex> guard(dcache_lock);
+    dentries.printStats(cout);
+}
+
+//create a method that prints what the page cache in front of the block file has done, after giving it a new size
+void VFS::cache(string megabytes) {
+    ExclusiveGuard<RWLock> guard(namespace_lock);//no file is being read or written
+    if (!megabytes.empty()) {
+        char* end = nullptr;
+        unsigned long long mb = strtoull(megabytes.c_str(), &end, 10);
+        if (*end != '\0' || mb == 0) {
+            cout << "Usage: cache [MB]" << endl;
+            return;
+        }
+        if (!files.setCacheSize(mb << 20)) {
+            cout << "The cache is in use." << endl;
+            return;
+        }
+    }
+    CacheStats c = files.cacheStats();
+    uint64_t lookups = c.hits + c.misses;
+    cout << "Cache      : " << c.frames * PAGE_BYTES / (1 << 20) << " MB, " << c.used << " of " << c.frames << " pages used, " << c.dirty << " dirty" << endl;
+    cout << "Lookups    : " << lookups << ", " << c.hits << " hits, " << c.misses << " misses, hit rate "
+         << fixed << setprecision(2) << (lookups > 0 ? 100.0 * c.hits / lookups : 0.0) << "%" << endl;
+    cout.unsetf(ios::fixed);
+    cout << setprecision(6);
+    cout << "Evictions  : " << c.evictions << endl;
+    cout << "Write-back : " << c.written << " blocks in " << c.write_calls << " pwritev calls" << endl;
+    cout << "Read       : " << c.read << " blocks in " << c.read_calls << " preadv calls" << endl;
+    cout << "Block file : " << c.file_bytes / (1 << 20) << " MB" << endl;
+}
+
+CacheStats VFS::cacheStats() {
+    return files.cacheStats();
+}
+
+//create a method that prints the logical size of the files and what their blocks take once identical blocks are stored once
+void VFS::df() {
+    SharedGuard<RWLock> guard(namespace_lock);
+    DedupStats d = files.dedupStats();
+    cout << "Logical  : " << root->getSize() << " bytes in the tree, " << trash.bytes() << " in the bin" << endl;
+    cout << "Blocks   : " << d.referenced << " referred to by the contents of files, " << d.referenced * BLOCK_BYTES / 1024 << " KB" << endl;
+    cout << "Physical : " << d.physical << " blocks in use, " << d.physical * BLOCK_BYTES / 1024 << " KB, dedup ratio "
+         << fixed << setprecision(2) << (d.physical > 0 ? (double)d.referenced / d.physical : 1.0) << endl;
+    cout.unsetf(ios::fixed);
+    cout << setprecision(6);
+    cout << "Shared   : " << d.shared << " blocks referred to more than once, " << d.indexed << " blocks indexed by their bytes" << endl;
+    cout << "Writes   : " << d.hits << " blocks found stored already, " << d.copies << " shared blocks copied before a write" << endl;
+}
+
+DedupStats VFS::dedupStats() {
+    return files.dedupStats();
+}
+
+//create a method that prints the totals of every thread's counters and histograms, with the bin and the arena as they are now
+void VFS::stats(string option, string file) {
+    if (option == "reset") {
+        Stats::instance().reset();
+        cout << "Statistics reset." << endl;
+        return;
+    }
+
+    StatTotals totals;
+    Stats::instance().totals(totals);
+    SharedGuard<RWLock> guard(namespace_lock);
+    size_t live, slab_bytes;
+    uint64_t created, destroyed;
+    {
+        lock_guard<mutex> index(index_lock);
+        live = pool.liveCount();
+        slab_bytes = pool.bytesReserved();
+        created = pool.createdCount();
+        destroyed = pool.destroyedCount();
+    }
+    CacheStats c = files.cacheStats();
+
+    if (option == "json") {
+        ofstream fout;
+        if (!file.empty()) {
+            fout.open(file.c_str());
+            if (!fout) {
+                cout << "Could not open '" << file << "'." << endl;
+                return;
+            }
+        }
+        ostream& out = file.empty() ? cout : fout;
+        out << "{";
+        Stats::instance().printJson(out, totals);
+        out << ", \"bin\": {\"items\": " << trash.size() << ", \"bytes\": " << trash.bytes() << ", \"purging\": " << purge_stack.size() << "}"
+            << ", \"arena\": {\"live\": " << live << ", \"created\": " << created << ", \"destroyed\": " << destroyed << ", \"bytes\": " << slab_bytes << "}"
+            << ", \"files\": {\"contents\": " << files.fileCount() << ", \"blocks_used\": " << files.usedBlocks() << ", \"regions\": " << files.regionCount() << ", \"free_extents\": " << files.freeExtentCount() << "}"
+            << ", \"cache\": {\"pages\": " << c.frames << ", \"used\": " << c.used << ", \"dirty\": " << c.dirty << ", \"hits\": " << c.hits << ", \"misses\": " << c.misses
+            << ", \"evictions\": " << c.evictions << ", \"blocks_written\": " << c.written << ", \"pwritev\": " << c.write_calls
+            << ", \"blocks_read\": " << c.read << ", \"preadv\": " << c.read_calls << "}}" << endl;
+        if (!file.empty()) {
+            cout << "Statistics written to '" << file << "'." << endl;
+        }
+        return;
+    }
+
+#ifdef VFS_NO_STATS
+    cout << "Latencies and counters are not collected in this build (VFS_NO_STATS)." << endl;
+#else
+    Stats::instance().print(cout, totals);
+#endif
+    cout << "bin               : " << trash.size() << " items, " << trash.bytes() << " bytes, " << purge_stack.size() << " Inodes waiting to be freed" << endl;
+    cout << "arena             : " << live << " Inodes live, " << created << " created, " << destroyed << " destroyed, " << slab_bytes / 1024 << " KB" << endl;
+    cout << "files             : " << files.fileCount() << " with contents, " << files.usedBlocks() * BLOCK_BYTES / 1024 << " KB in blocks, "
+         << files.regionCount() << " regions of " << REGION_BLOCKS * BLOCK_BYTES / (1 << 20) << " MB, " << files.freeExtentCount() << " free extents" << endl;
+    cout << "cache             : " << c.used << " of " << c.frames << " pages used, " << c.hits << " hits, " << c.misses << " misses, "
+         << c.evictions << " evictions, " << c.written << " blocks written back" << endl;
+}
+
+//create a method that adds up what the Inodes of a subtree hold: the Inode itself, heap allocated names, child vectors and indexes
+void VFS::footprint(Inode* top, size_t& inodes, size_t& bytes) {
+    inodes = bytes = 0;
+    walkTree(top, [&](Inode* node) -> Vector<Inode*>* {
+        inodes++;
+        bytes += sizeof(Inode);
+        if (node->getName().capacity() > 15) {//longer names do not fit the string's own buffer
+            bytes += node->getName().capacity() + 1;
+        }
+        bytes += node->children.heapBytes() + node->index.memoryBytes();//up to 8 children are inside the Inode
+        if (node->ordered != nullptr) {
+            bytes += node->ordered->memoryBytes();
+        }
+        return &node->children;//a lazy folder, or a copy that shares its subtree, has no children of its own
+    });
+}
 
-    // Update parent sizes
-    Inode* temp = curr_inode;
-    while (temp != nullptr) {//stops after traversing through the root directory
-        unsigned int totalSize = 0;
-        Vector<Inode*>& children = temp->getChildren();
-        for (size_t i = 0; i < children.size(); ++i) {//traverse through all the children
-            totalSize += children[i]->getSize();
+//create a method that takes, lists or drops the snapshots of the tree; taking one costs one Inode
+void VFS::snapshotCommand(string action, string name) {
+    ExclusiveGuard<RWLock> guard(namespace_lock);
+    if (action == "create") {
+        if (name.empty() || name.find('/') != string::npos) {
+            cout << "Usage: snapshot create name" << endl;
+            return;
+        }
+        int64_t now = getTime();
+        if (createView(name, now) == nullptr) {
+            cout << "Snapshot '" << name << "' already exists." << endl;
+            return;
+        }
+        logChange(root, J_SNAPSHOT, name, "", 0, now);
+        cout << "Snapshot '" << name << "' created, read-only at /.snap/" << name << endl;
+    } else if (action == "drop") {
+        if (!dropView(name)) {
+            cout << "Snapshot '" << name << "' not found." << endl;
+            return;
+        }
+        logChange(root, J_DROP, name, "", 0, 0);
+        cout << "Snapshot '" << name << "' dropped." << endl;
+    } else if (action == "list" || action.empty()) {
+        if (views.empty()) {
+            cout << "No snapshots." << endl;
+            return;
+        }
+        //what a snapshot costs is the Inodes of its own, made as the tree diverged from it
+        cout << "Snapshots: " << views.size() << endl;
+        for (size_t i = 0; i < views.size(); ++i) {
+            size_t inodes, bytes;
+            footprint(views[i].root, inodes, bytes);
+            cout << formatTime(views[i].created) << "  " << setw(10) << views[i].root->getSize() << " bytes  " << setw(8) << inodes << " Inodes  "
+                 << setw(8) << bytes / 1024 << " KB  /.snap/" << views[i].name << endl;
         }
-        temp->setSize(totalSize);//set the new updated size
-        temp = temp->getParent();//forward it to the parent inode
+    } else {
+        cout << "Unknown action '" << action << "', use create, list or drop." << endl;
+    }
+}
+
+//create a method that takes a snapshot as a copy of the root outside the tree; a change to the tree expands it along the path to the change
+Inode* VFS::createView(const string& name, int64_t created) {
+    if (findView(name) != nullptr) {
+        return nullptr;
+    }
+    Inode* view;
+    {
+        lock_guard<mutex> guard(index_lock);
+        view = clones.copy(root, nullptr, name);
+    }
+    VFS_COUNT(S_CREATED, 1);
+    SnapshotView taken = {name, view, created};
+    views.push_back(taken);
+    return view;
+}
+
+//create a method that drops a snapshot; its Inodes are freed by purgeStep like a purged bin item
+bool VFS::dropView(const string& name) {
+    for (size_t i = 0; i < views.size(); ++i) {
+        if (views[i].name == name) {
+            purge_stack.push_back(views[i].root);
+            views.erase(views.begin() + i);
+            return true;
+        }
+    }
+    return false;
+}
+
+Inode* VFS::findView(const string& name) {
+    for (size_t i = 0; i < views.size(); ++i) {
+        if (views[i].name == name) {
+            return views[i].root;
+        }
+    }
+    return nullptr;
+}
+
+bool VFS::isView(Inode* node) {
+    for (size_t i = 0; i < views.size(); ++i) {
+        if (views[i].root == node) {
+            return true;
+        }
+    }
+    return false;
+}
+
+Inode* VFS::viewOf(Inode* node) {
+    while (node != nullptr && node->getParent() != nullptr) {
+        node = node->getParent();
+    }
+    return node != root && isView(node) ? node : nullptr;
+}
+
+//create a method that checks whether the table still matches the tree
+bool VFS::tableCurrent() {
+    return table_version == tree_version && table_expanded == clones.expandedCount();
+}
+
+//create a method that builds the Inode table and prints the memory per Inode of both layouts
+void VFS::compact() {
+    ExclusiveGuard<RWLock> guard(namespace_lock);
+    table.build(root);
+    table_version = tree_version;
+    table_expanded = clones.expandedCount();
+
+    size_t tree_bytes, tree_nodes;
+    footprint(root, tree_nodes, tree_bytes);
+
+    size_t n = table.count();
+    cout << "Inodes     : " << n << endl;
+    cout << "Tree layout: " << tree_bytes << " bytes, " << tree_bytes / tree_nodes << " bytes per Inode";
+    if (tree_nodes != n) {
+        cout << " (" << tree_nodes << " Inodes, the others are shared by copies)";
     }
+    cout << endl;
+    cout << "Table      : " << table.memoryBytes() << " bytes, " << table.memoryBytes() / n << " bytes per Inode" << endl;
 }
 
 //create a function to exit the function
 void VFS::exit() {
-    // writeToFile(); // Save changes before exiting
+    ExclusiveGuard<RWLock> guard(namespace_lock);//let the other sessions finish their commands
+    finishCheckpoint(true);
+    journal.close(); // Flush the journal before exiting
     std::exit(EXIT_SUCCESS); // or EXIT_FAILURE, depending on the context
 }
 